@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Convert a list of 7-segment frames to animation stream for gbj_tm1637_anim.
+
+Every non-empty input line defines one frame as its duration in milliseconds
+followed by hexadecimal segment masks of all digits with radix segment in the
+most significant bit, e.g.:
+
+    # duration  digit0 digit1 digit2 digit3
+    100         3f     06     5b     4f
+
+Text after '#' is a comment. The output is C header with the stream stored
+in flash memory, which is played by the class gbj_tm1637_anim.
+"""
+
+import argparse
+import sys
+
+OP_DELTA = 0b00000000
+OP_KEY = 0b01000000
+OP_HOLD = 0b10000000
+OP_END = 0b11000000
+OP_LOOP = 0b11000001
+
+TIMING_UNIT = 10
+DURATION_MAX = 0xFF
+HOLD_MAX = 64
+
+
+def parse_frames(lines):
+    """Return list of (duration_units, masks) tuples."""
+    frames = []
+    for number, line in enumerate(lines, 1):
+        line = line.split('#', 1)[0].split()
+        if not line:
+            continue
+        try:
+            duration = int(line[0])
+            masks = tuple(int(item, 16) for item in line[1:])
+        except ValueError:
+            sys.exit(f'line {number}: invalid number')
+        if not 1 <= len(masks) <= 6 or any(mask > 0xFF for mask in masks):
+            sys.exit(f'line {number}: expected 1 to 6 segment masks')
+        if frames and len(masks) != len(frames[0][1]):
+            sys.exit(f'line {number}: inconsistent number of digits')
+        frames.append((round(duration / TIMING_UNIT), masks))
+    if not frames:
+        sys.exit('no frames')
+    return frames
+
+
+def encode_hold(units):
+    """Encode keeping of current frame for duration units."""
+    stream = []
+    while units > 0:
+        if units >= DURATION_MAX:
+            count = min(units // DURATION_MAX, HOLD_MAX)
+            stream += [OP_HOLD | (count - 1), DURATION_MAX]
+            units -= count * DURATION_MAX
+        else:
+            stream += [OP_HOLD, units]
+            units = 0
+    return stream
+
+
+def encode(frames, loop):
+    """Encode frames to animation stream."""
+    digits = len(frames[0][1])
+    stream = [digits]
+    previous = None
+    pending = 0
+    for units, masks in frames:
+        if masks == previous:
+            pending += units
+            continue
+        stream += encode_hold(pending)
+        changed = [digit for digit in range(digits)
+                   if previous is None or masks[digit] != previous[digit]]
+        if len(changed) == digits:
+            stream += [OP_KEY] + list(masks)
+        else:
+            stream.append(OP_DELTA | sum(1 << digit for digit in changed))
+            stream += [masks[digit] for digit in changed]
+        stream.append(min(units, DURATION_MAX))
+        pending = units - min(units, DURATION_MAX)
+        previous = masks
+    stream += encode_hold(pending)
+    stream.append(OP_LOOP if loop else OP_END)
+    return stream
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', type=argparse.FileType('r'),
+                        help='file with frames, "-" for standard input')
+    parser.add_argument('-n', '--name', default='gbjAnim7seg',
+                        help='name of the generated array')
+    parser.add_argument('-l', '--loop', action='store_true',
+                        help='repeat the animation endlessly')
+    args = parser.parse_args()
+    frames = parse_frames(args.input)
+    stream = encode(frames, args.loop)
+    print(f'// Generated by anim7seg.py: {len(frames)} frames, '
+          f'{len(stream)} bytes')
+    print(f'const uint8_t {args.name}[] PROGMEM =')
+    print('{')
+    for index in range(0, len(stream), 12):
+        chunk = ', '.join(f'0x{byte:02x}' for byte in stream[index:index + 12])
+        print(f'  {chunk},')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()
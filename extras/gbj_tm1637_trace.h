@@ -0,0 +1,342 @@
+/**
+ * @file gbj_tm1637_trace.h
+ * @brief Recorder of TM1637 bus pin activity with export to VCD format.
+ * @details The include file defines the hook GBJ_TM1637_TRACE of the library,
+ * so that it has to be included before the library header file. Every mode
+ * change, write, and read on bus pins is recorded with timestamp in
+ * microseconds and can be exported as Value Change Dump file, which common
+ * waveform viewers (e.g., GTKWave, PulseView) open.
+ * @details Along with clock and data lines the export contains decoded
+ * signals: frame between start and stop condition, acknowledge window, and
+ * transmitted byte value. Decoded events are also marked by comments.
+ * @details The recorder is aimed for simulated host environment or a board
+ * with enough operating memory for the event buffer.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_TRACE_H
+#define GBJ_TM1637_TRACE_H
+
+#include <Arduino.h>
+
+/** @brief Capacity of the event buffer. */
+#ifndef GBJ_TM1637_TRACE_EVENTS
+  #define GBJ_TM1637_TRACE_EVENTS 512
+#endif
+
+#define GBJ_TM1637_TRACE(pin, event, value)                                    \
+  gbj_tm1637_trace::record(pin, event, value)
+
+/**
+ * @class gbj_tm1637_trace
+ * @brief Static recorder of bus pin events.
+ */
+class gbj_tm1637_trace
+{
+public:
+  /**
+   * @brief Record one pin event.
+   * @details The method is called by the library through the trace hook.
+   * Events beyond the buffer capacity are dropped and overflow flag is set.
+   * @param pin Pin number.
+   * @param event Event type, 'm' for mode, 'w' for write, 'r' for read.
+   * @param value Pin mode or logical level.
+   */
+  static inline void record(uint8_t pin, uint8_t event, uint8_t value)
+  {
+    Trace &trace = getTrace();
+    if (trace.count >= GBJ_TM1637_TRACE_EVENTS)
+    {
+      trace.overflow = true;
+      return;
+    }
+    Event &item = trace.events[trace.count++];
+    item.timestamp = micros();
+    item.pin = pin;
+    item.event = event;
+    item.value = value;
+  }
+
+  /**
+   * @brief Discard all recorded events.
+   */
+  static inline void clear()
+  {
+    getTrace().count = 0;
+    getTrace().overflow = false;
+  }
+
+  /**
+   * @brief Get number of recorded events.
+   * @return Number of events in the buffer.
+   */
+  static inline uint16_t getEvents() { return getTrace().count; }
+
+  /**
+   * @brief Check whether some events have been dropped.
+   * @return True if the buffer overflowed since recent clearing.
+   */
+  static inline bool isOverflow() { return getTrace().overflow; }
+
+  /**
+   * @brief Export recorded events in Value Change Dump format.
+   * @details Timestamps are relative to the first recorded event in
+   * microseconds. The data line is in high impedance state while the data pin
+   * is an input until its level is read.
+   * @param out Output stream, e.g., Serial or a file.
+   * @param pinClk Clock pin number used by the library instance.
+   * @param pinDio Data pin number used by the library instance.
+   */
+  static void exportVcd(Print &out, uint8_t pinClk, uint8_t pinDio)
+  {
+    Trace &trace = getTrace();
+    out.print("$version gbj_tm1637_trace $end\n");
+    out.print("$timescale 1 us $end\n");
+    out.print("$scope module tm1637 $end\n");
+    out.print("$var wire 1 ! clk $end\n");
+    out.print("$var wire 1 \" dio $end\n");
+    out.print("$var wire 1 # frame $end\n");
+    out.print("$var wire 1 % ack $end\n");
+    out.print("$var reg 8 & data $end\n");
+    out.print("$upscope $end\n");
+    out.print("$enddefinitions $end\n");
+    out.print("#0\n$dumpvars\nx!\nx\"\n0#\n0%\nbxxxxxxxx &\n$end\n");
+    Decoder dec = { 0, 0, 0xFF, 0xFF, 0xFF, false, false, false, 0, 0, 0 };
+    uint32_t timeBase = trace.count ? trace.events[0].timestamp : 0;
+    for (uint16_t i = 0; i < trace.count; i++)
+    {
+      const Event &item = trace.events[i];
+      if (item.pin != pinClk && item.pin != pinDio)
+        continue;
+      dec.time = item.timestamp - timeBase;
+      if (item.pin == pinClk)
+      {
+        decodeClk(out, dec, item);
+      }
+      else
+      {
+        decodeDio(out, dec, item);
+      }
+    }
+    if (trace.overflow)
+    {
+      out.print("$comment overflow $end\n");
+    }
+  }
+
+private:
+  /**
+   * @brief Recorded pin event.
+   */
+  struct Event
+  {
+    /** @brief Time of the event in microseconds. */
+    uint32_t timestamp;
+    /** @brief Pin number. */
+    uint8_t pin;
+    /** @brief Event type. */
+    uint8_t event;
+    /** @brief Pin mode or logical level. */
+    uint8_t value;
+  };
+
+  /**
+   * @brief Event buffer.
+   */
+  struct Trace
+  {
+    /** @brief Recorded events. */
+    Event events[GBJ_TM1637_TRACE_EVENTS];
+    /** @brief Number of recorded events. */
+    uint16_t count;
+    /** @brief Flag about dropped events. */
+    bool overflow;
+  };
+
+  /**
+   * @brief Bus state reconstructed from events.
+   */
+  struct Decoder
+  {
+    /** @brief Time of the processed event. */
+    uint32_t time;
+    /** @brief Time of the recently dumped value change. */
+    uint32_t timeDumped;
+    /** @brief Clock level. */
+    uint8_t clk;
+    /** @brief Data level driven by the microcontroller. */
+    uint8_t dio;
+    /** @brief Data level read from the controller. */
+    uint8_t dioRead;
+    /** @brief Flag about data pin in input mode. */
+    bool input;
+    /** @brief Flag about running frame between start and stop. */
+    bool frame;
+    /** @brief Flag about running acknowledge window. */
+    bool ack;
+    /** @brief Number of received bits of current byte. */
+    uint8_t bits;
+    /** @brief Current byte value. */
+    uint8_t data;
+    /** @brief Number of bytes in current frame. */
+    uint8_t bytes;
+  };
+
+  static inline Trace &getTrace()
+  {
+    static Trace trace;
+    return trace;
+  }
+
+  static inline void printTime(Print &out, Decoder &dec)
+  {
+    if (dec.time == dec.timeDumped)
+      return;
+    out.print('#');
+    printDecimal(out, dec.time);
+    out.print('\n');
+    dec.timeDumped = dec.time;
+  }
+
+  static inline void printLevel(Print &out,
+                                Decoder &dec,
+                                uint8_t level,
+                                char id)
+  {
+    printTime(out, dec);
+    out.print(level ? '1' : '0');
+    out.print(id);
+    out.print('\n');
+  }
+
+  /**
+   * @brief Print decimal number digit by digit.
+   * @details Only character output is used, so that the export does not
+   * depend on numeric overloads of the output stream.
+   * @param out Output stream.
+   * @param value Number to print.
+   */
+  static inline void printDecimal(Print &out, uint32_t value)
+  {
+    char digits[10];
+    uint8_t length = 0;
+    do
+    {
+      digits[length++] = '0' + value % 10;
+      value /= 10;
+    } while (value);
+    while (length)
+    {
+      out.print(digits[--length]);
+    }
+  }
+
+  static inline void printHex(Print &out, uint8_t data)
+  {
+    const char *digits = "0123456789ABCDEF";
+    out.print(digits[data >> 4]);
+    out.print(digits[data & 0x0F]);
+  }
+
+  static void decodeClk(Print &out, Decoder &dec, const Event &item)
+  {
+    if (item.event != 'w')
+      return;
+    uint8_t level = item.value ? 1 : 0;
+    if (level == dec.clk)
+      return;
+    dec.clk = level;
+    printLevel(out, dec, level, '!');
+    // Data bits are sampled on rising clock edge while the pin is output
+    if (level && dec.frame && !dec.input)
+    {
+      dec.data |= (dec.dio & 0x01) << dec.bits;
+      if (++dec.bits == 8)
+      {
+        out.print('b');
+        for (uint8_t bit = 8; bit > 0; bit--)
+        {
+          out.print((dec.data >> (bit - 1)) & 0x01 ? '1' : '0');
+        }
+        out.print(" &\n$comment ");
+        out.print(dec.bytes++ ? "data 0x" : "command 0x");
+        printHex(out, dec.data);
+        out.print(" $end\n");
+        dec.bits = 0;
+        dec.data = 0;
+      }
+    }
+  }
+
+  static void decodeDio(Print &out, Decoder &dec, const Event &item)
+  {
+    switch (item.event)
+    {
+      case 'm':
+        dec.input = item.value != OUTPUT;
+        if (dec.input)
+        {
+          dec.ack = true;
+          dec.dioRead = 0xFF;
+          printTime(out, dec);
+          out.print("z\"\n");
+          printLevel(out, dec, 1, '%');
+        }
+        else
+        {
+          if (dec.ack)
+          {
+            dec.ack = false;
+            printLevel(out, dec, 0, '%');
+            out.print(dec.dioRead ? "$comment nak $end\n"
+                                  : "$comment ack $end\n");
+          }
+          printLevel(out, dec, dec.dio, '"');
+        }
+        break;
+
+      case 'r':
+        if (dec.input && (item.value ? 1 : 0) != dec.dioRead)
+        {
+          dec.dioRead = item.value ? 1 : 0;
+          printLevel(out, dec, dec.dioRead, '"');
+        }
+        break;
+
+      case 'w':
+      {
+        uint8_t level = item.value ? 1 : 0;
+        uint8_t levelPrev = dec.dio;
+        dec.dio = level;
+        if (dec.input || level == levelPrev)
+          break;
+        printLevel(out, dec, level, '"');
+        if (dec.clk != 1)
+          break;
+        // Data change at high clock is either start or stop condition
+        if (!level && !dec.frame)
+        {
+          dec.frame = true;
+          dec.bits = dec.data = dec.bytes = 0;
+          printLevel(out, dec, 1, '#');
+          out.print("$comment start $end\n");
+        }
+        else if (level && dec.frame)
+        {
+          dec.frame = false;
+          printLevel(out, dec, 0, '#');
+          out.print("$comment stop $end\n");
+        }
+        break;
+      }
+    }
+  }
+};
+
+#endif
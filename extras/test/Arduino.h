@@ -0,0 +1,116 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal host stub of the Arduino core for library tests.
+ * @details The stub provides just what the library headers use, so that they
+ * compile with a host compiler. Pins are inert and the data line always
+ * reads low, i.e., every byte is acknowledged. Time advances by one
+ * microsecond at every reading of it.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+
+#define constrain(x, low, high)                                                \
+  ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+template<typename T>
+inline T min(T a, T b)
+{
+  return a < b ? a : b;
+}
+
+template<typename T>
+inline T max(T a, T b)
+{
+  return a > b ? a : b;
+}
+
+inline uint32_t &hostMicros()
+{
+  static uint32_t tsMicros = 0;
+  return tsMicros;
+}
+
+inline uint32_t micros() { return hostMicros()++; }
+inline uint32_t millis() { return hostMicros() / 1000; }
+inline void delayMicroseconds(unsigned int) {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+inline char *ltoa(long value, char *text, int)
+{
+  sprintf(text, "%ld", value);
+  return text;
+}
+
+inline char *dtostrf(double value,
+                     signed char width,
+                     unsigned char precision,
+                     char *text)
+{
+  sprintf(text, "%*.*f", width, precision, value);
+  return text;
+}
+
+class String
+{
+public:
+  String(const char *text = "")
+    : text_(text)
+  {
+  }
+  const char *c_str() const { return text_.c_str(); }
+  unsigned int length() const { return text_.length(); }
+
+private:
+  std::string text_;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t count = 0;
+    while (size--)
+    {
+      count += write(*buffer++);
+    }
+    return count;
+  }
+  size_t write(const char *text)
+  {
+    return write((const uint8_t *)text, strlen(text));
+  }
+  size_t print(const char *text) { return write(text); }
+  size_t print(char ascii) { return write((uint8_t)ascii); }
+};
+
+#endif
@@ -0,0 +1,305 @@
+/**
+ * @file gbj_tm1637_model.h
+ * @brief Reference model of screen buffer semantics of the library.
+ * @details The model implements the rules from the README section "Screen
+ * buffer semantics" in plain C++ as directly as possible, without change
+ * tracking by bit masks, packed status, or transmission optimizations. It
+ * serves as an oracle for differential tests of the library, which compare
+ * screen buffer, print position, and bytes transmitted to the controller.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_MODEL_H
+#define GBJ_TM1637_MODEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @class gbj_tm1637_model
+ * @brief Plain model of one TM1637 display.
+ */
+class gbj_tm1637_model
+{
+public:
+  /** @brief Bus frame, i.e., bytes between start and stop condition. */
+  typedef std::vector<uint8_t> Frame;
+
+  /** @brief Bus frames of one operation. */
+  typedef std::vector<Frame> Frames;
+
+  /**
+   * @brief Construct a model.
+   * @param digits Number of controlled digits.
+   * @param fontTable Font table with pairs of ASCII code and segment mask.
+   * @param fontTableSize Number of bytes of the font table.
+   */
+  gbj_tm1637_model(uint8_t digits,
+                   const uint8_t *fontTable,
+                   uint8_t fontTableSize)
+    : digits_(digits)
+    , font_(fontTable)
+    , glyphs_(fontTableSize / 2)
+    , buffer_(digits, 0)
+    , changed_(digits, true)
+    , digit_(0)
+  {
+  }
+
+  /**
+   * @brief Initialize display by clearing it and turning it on.
+   * @return Bus frames of the operation.
+   */
+  Frames begin()
+  {
+    displayClear();
+    return Frames(1, Frame(1, 0x88 | 3));
+  }
+
+  /**
+   * @brief Transmit all digits.
+   * @param reorder Optional screen buffer index for every display position.
+   * @return Bus frames of the operation.
+   */
+  Frames display(const uint8_t *reorder = 0)
+  {
+    Frames frames(1, Frame(1, 0x40));
+    Frame frame(1, 0xC0);
+    for (uint8_t address = 0; address < digits_; address++)
+    {
+      frame.push_back(buffer_[index(address, reorder)]);
+    }
+    frames.push_back(frame);
+    changed_.assign(digits_, false);
+    return frames;
+  }
+
+  /**
+   * @brief Transmit changed digits, every run of them in display order
+   * within one address command.
+   * @param reorder Optional screen buffer index for every display position.
+   * @return Bus frames of the operation.
+   */
+  Frames displayUpdate(const uint8_t *reorder = 0)
+  {
+    Frames frames;
+    bool changed = false;
+    for (uint8_t digit = 0; digit < digits_; digit++)
+    {
+      changed = changed || changed_[digit];
+    }
+    if (!changed)
+      return frames;
+    frames.push_back(Frame(1, 0x40));
+    for (uint8_t address = 0; address < digits_; address++)
+    {
+      if (!changed_[index(address, reorder)])
+        continue;
+      // Start a new address command at the beginning of a run
+      if (address == 0 || !changed_[index(address - 1, reorder)])
+        frames.push_back(Frame(1, 0xC0 | address));
+      frames.back().push_back(buffer_[index(address, reorder)]);
+    }
+    changed_.assign(digits_, false);
+    return frames;
+  }
+
+  /**
+   * @brief Clear glyph and radix segments of all digits.
+   * @param digit Print position, kept after the last digit if out of range.
+   */
+  void displayClear(uint8_t digit = 0)
+  {
+    for (uint8_t i = 0; i < digits_; i++)
+    {
+      store(i, 0x00);
+    }
+    digit_ = digit < digits_ ? digit : digits_;
+  }
+
+  /**
+   * @brief Set print position if within the display.
+   * @param digit Print position.
+   */
+  void placePrint(uint8_t digit = 0)
+  {
+    if (digit < digits_)
+      digit_ = digit;
+  }
+
+  /**
+   * @brief Set glyph segments of a digit and move print position after it.
+   * @param segmentMask Glyph segments, radix bit is ignored.
+   * @param digit Digit index.
+   */
+  void printDigit(uint8_t segmentMask, uint8_t digit)
+  {
+    if (digit >= digits_)
+      return;
+    store(digit, (buffer_[digit] & 0x80) | (segmentMask & 0x7F));
+    digit_ = digit + 1;
+  }
+
+  /**
+   * @brief Set glyph segments of all digits.
+   * @param segmentMask Glyph segments, radix bit is ignored.
+   */
+  void printDigitAll(uint8_t segmentMask)
+  {
+    for (uint8_t digit = 0; digit < digits_; digit++)
+    {
+      printDigit(segmentMask, digit);
+    }
+  }
+
+  /**
+   * @brief Turn on, off, or toggle radix segment of a digit.
+   * @param digit Digit index.
+   */
+  void printRadixOn(uint8_t digit)
+  {
+    if (digit < digits_)
+      store(digit, buffer_[digit] | 0x80);
+  }
+
+  void printRadixOff(uint8_t digit)
+  {
+    if (digit < digits_)
+      store(digit, buffer_[digit] & 0x7F);
+  }
+
+  void printRadixToggle(uint8_t digit)
+  {
+    if (digit < digits_)
+      store(digit, buffer_[digit] ^ 0x80);
+  }
+
+  /**
+   * @brief Write one character.
+   * @details A glyph is printed at the print position if it is within the
+   * display. A missing glyph is ignored, except a radix marker, which turns
+   * on the radix segment of the previous digit.
+   * @param ascii Character.
+   * @return Number of printed digits.
+   */
+  size_t write(uint8_t ascii)
+  {
+    int mask = lookup(ascii);
+    if (mask < 0)
+    {
+      if (isMarker(ascii) && digit_ > 0)
+        printRadixOn(digit_ - 1);
+      return 0;
+    }
+    if (digit_ >= digits_)
+      return 0;
+    printDigit(mask, digit_);
+    return 1;
+  }
+
+  /**
+   * @brief Write a text.
+   * @details Once the display is full, only radix markers are processed and
+   * the first other character ends the text.
+   * @param text Text.
+   * @return Number of printed digits.
+   */
+  size_t write(const char *text)
+  {
+    size_t digits = 0;
+    for (; *text; text++)
+    {
+      if (digit_ >= digits_ && !isMarker(*text))
+        break;
+      digits += write((uint8_t)*text);
+    }
+    return digits;
+  }
+
+  /**
+   * @brief Write a text to cleared display.
+   * @param text Text.
+   * @param digit Start print position.
+   */
+  void printText(const char *text, uint8_t digit = 0)
+  {
+    displayClear(digit);
+    write(text);
+  }
+
+  /**
+   * @brief Write a text to display with cleared glyphs and kept radixes.
+   * @param text Text.
+   * @param digit Start print position.
+   */
+  void printGlyphs(const char *text, uint8_t digit = 0)
+  {
+    printDigitAll(0x00);
+    placePrint(digit);
+    write(text);
+  }
+
+  /**
+   * @brief Get segment mask of a digit, 0 for a digit out of range.
+   * @param digit Digit index.
+   */
+  uint8_t getSegments(uint8_t digit)
+  {
+    return digit < digits_ ? buffer_[digit] : 0x00;
+  }
+
+  /**
+   * @brief Get print position.
+   */
+  uint8_t getPrint() { return digit_; }
+
+private:
+  /** @brief Number of controlled digits. */
+  uint8_t digits_;
+  /** @brief Font table. */
+  const uint8_t *font_;
+  /** @brief Number of glyphs in the font table. */
+  uint8_t glyphs_;
+  /** @brief Segment masks of digits including radix segments. */
+  std::vector<uint8_t> buffer_;
+  /** @brief Flags about digits changed since recent transmission. */
+  std::vector<bool> changed_;
+  /** @brief Print position. */
+  uint8_t digit_;
+
+  void store(uint8_t digit, uint8_t data)
+  {
+    if (buffer_[digit] != data)
+      changed_[digit] = true;
+    buffer_[digit] = data;
+  }
+
+  uint8_t index(uint8_t address, const uint8_t *reorder)
+  {
+    return reorder ? reorder[address] : address;
+  }
+
+  int lookup(uint8_t ascii)
+  {
+    for (uint8_t glyph = 0; glyph < glyphs_; glyph++)
+    {
+      if (font_[2 * glyph] == ascii)
+        return font_[2 * glyph + 1] & 0x7F;
+    }
+    return -1;
+  }
+
+  static bool isMarker(uint8_t ascii)
+  {
+    return ascii == '.' || ascii == ',' || ascii == ':';
+  }
+};
+
+#endif
@@ -0,0 +1,402 @@
+/**
+ * @file test_semantics.cpp
+ * @brief Randomized differential test of screen buffer semantics.
+ * @details The test drives the library and the reference model from the
+ * include file gbj_tm1637_model.h by the same seeded random sequences of
+ * printing and transmitting operations. After every operation it compares
+ * screen buffers, print positions, and bytes transmitted on the bus, which
+ * are decoded from pin activity captured by the trace hook of the library.
+ * The first difference is reported with the seed and the sequence of
+ * operations leading to it.
+ * @details Build and run on a host from the library root folder:
+ *
+ *     g++ -std=c++11 -Wall -Wextra -I extras/test -I src \
+ *       extras/test/test_semantics.cpp -o test_semantics
+ *     ./test_semantics [seed] [sequences]
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#include <Arduino.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gbj_tm1637_model.h"
+
+/**
+ * @class BusDecoder
+ * @brief Decoder of bytes transmitted on the bus from pin events.
+ * @details A frame starts when data line falls while clock is high and ends
+ * when data line rises while clock is high. Bits are sampled at rising edges
+ * of clock while data pin is output, so that acknowledge clocks are skipped.
+ */
+class BusDecoder
+{
+public:
+  static const uint8_t PIN_CLK = 2;
+  static const uint8_t PIN_DIO = 3;
+
+  void record(uint8_t pin, uint8_t event, uint8_t value)
+  {
+    if (event == 'm' && pin == PIN_DIO)
+    {
+      output_ = value == OUTPUT;
+    }
+    else if (event == 'w' && pin == PIN_CLK)
+    {
+      if (value && !clk_ && inFrame_ && output_)
+        sample();
+      clk_ = value;
+    }
+    else if (event == 'w' && pin == PIN_DIO)
+    {
+      if (clk_ && output_ && dio_ && !value)
+      {
+        inFrame_ = true;
+        frames_.push_back(gbj_tm1637_model::Frame());
+        bits_ = 0;
+      }
+      else if (clk_ && output_ && !dio_ && value)
+      {
+        inFrame_ = false;
+      }
+      dio_ = value;
+    }
+  }
+
+  gbj_tm1637_model::Frames take()
+  {
+    gbj_tm1637_model::Frames frames;
+    frames.swap(frames_);
+    return frames;
+  }
+
+private:
+  gbj_tm1637_model::Frames frames_;
+  uint8_t byte_ = 0;
+  uint8_t bits_ = 0;
+  bool clk_ = true;
+  bool dio_ = true;
+  bool output_ = true;
+  bool inFrame_ = false;
+
+  void sample()
+  {
+    // Bits are sent from LSB
+    byte_ = (byte_ >> 1) | (dio_ ? 0x80 : 0x00);
+    if (++bits_ == 8)
+    {
+      frames_.back().push_back(byte_);
+      bits_ = 0;
+    }
+  }
+};
+
+BusDecoder bus;
+
+#define GBJ_TM1637_TRACE(pin, event, value) bus.record(pin, event, value)
+#include "gbj_tm1637.h"
+#include "../font7seg_basic.h"
+
+/**
+ * @brief Random test sequence runner for one display configuration.
+ */
+class Runner
+{
+public:
+  Runner(uint32_t seed, uint8_t digits)
+    : random_(seed)
+    , digits_(digits)
+    , disp_(BusDecoder::PIN_CLK, BusDecoder::PIN_DIO, digits)
+    , model_(digits, gbjFont7segTable, sizeof(gbjFont7segTable))
+  {
+    disp_.setFont(gbjFont7segTable, sizeof(gbjFont7segTable));
+    for (uint8_t digit = 0; digit < digits; digit++)
+    {
+      reorder_[digit] = digit;
+    }
+    std::shuffle(reorder_, reorder_ + digits, random_);
+  }
+
+  /**
+   * @brief Run a sequence of random operations.
+   * @param operations Number of operations.
+   * @return True if library and model agree after every operation.
+   */
+  bool run(uint16_t operations)
+  {
+    log("begin()");
+    bus.take();
+    disp_.begin();
+    if (!compare(model_.begin()))
+      return false;
+    for (uint16_t i = 0; i < operations; i++)
+    {
+      if (!compare(step()))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  std::mt19937 random_;
+  uint8_t digits_;
+  gbj_tm1637 disp_;
+  gbj_tm1637_model model_;
+  uint8_t reorder_[GBJ_TM1637_DIGITS];
+  std::vector<std::string> log_;
+
+  uint8_t pick(uint8_t limit) { return random_() % limit; }
+
+  /**
+   * @brief Random digit index including indexes beyond the display.
+   */
+  uint8_t pickDigit() { return pick(digits_ + 2); }
+
+  /**
+   * @brief Random text of glyphs, radix markers, and missing characters.
+   */
+  std::string pickText()
+  {
+    static const char alphabet[] = "0123456789AbCdEF- ...,,::#@~";
+    std::string text;
+    uint8_t length = pick(2 * digits_ + 3);
+    for (uint8_t i = 0; i < length; i++)
+    {
+      text += alphabet[pick(sizeof(alphabet) - 1)];
+    }
+    return text;
+  }
+
+  void log(const std::string &operation) { log_.push_back(operation); }
+
+  std::string format(const char *name, unsigned a, unsigned b)
+  {
+    char text[48];
+    snprintf(text, sizeof(text), "%s(0x%02x, %u)", name, a, b);
+    return text;
+  }
+
+  std::string format(const char *name, unsigned a)
+  {
+    char text[32];
+    snprintf(text, sizeof(text), "%s(%u)", name, a);
+    return text;
+  }
+
+  std::string format(const char *name, const std::string &text, unsigned a)
+  {
+    return std::string(name) + "(\"" + text + "\", " +
+           std::to_string(a) + ")";
+  }
+
+  /**
+   * @brief Perform one random operation on both library and model.
+   * @return Bus frames expected from the model.
+   */
+  gbj_tm1637_model::Frames step()
+  {
+    gbj_tm1637_model::Frames expected;
+    uint8_t digit = pickDigit();
+    uint8_t mask = pick(0xFF);
+    std::string text = pickText();
+    switch (pick(16))
+    {
+      case 0:
+        log(format("write", text, 0));
+        disp_.write(text.c_str());
+        model_.write(text.c_str());
+        break;
+
+      case 1:
+        log(format("writeByte", text.empty() ? 0 : text[0]));
+        if (!text.empty())
+        {
+          disp_.write((uint8_t)text[0]);
+          model_.write((uint8_t)text[0]);
+        }
+        break;
+
+      case 2:
+        log(format("writeBuffer", text, 0));
+        disp_.write((const uint8_t *)text.c_str(), text.size());
+        model_.write(text.c_str());
+        break;
+
+      case 3:
+        log(format("printDigit", mask, digit));
+        disp_.printDigit(mask, digit);
+        model_.printDigit(mask, digit);
+        break;
+
+      case 4:
+        log(format("printDigitAll", mask, 0));
+        disp_.printDigitAll(mask);
+        model_.printDigitAll(mask);
+        break;
+
+      case 5:
+        log(format(mask & 1 ? "printDigitOn" : "printDigitOff", digit));
+        if (mask & 1)
+        {
+          disp_.printDigitOn(digit);
+          model_.printDigit(0x7F, digit);
+        }
+        else
+        {
+          disp_.printDigitOff(digit);
+          model_.printDigit(0x00, digit);
+        }
+        break;
+
+      case 6:
+        log(format("printRadixOn", digit));
+        disp_.printRadixOn(digit);
+        model_.printRadixOn(digit);
+        break;
+
+      case 7:
+        log(format("printRadixOff", digit));
+        disp_.printRadixOff(digit);
+        model_.printRadixOff(digit);
+        break;
+
+      case 8:
+        log(format("printRadixToggle", digit));
+        disp_.printRadixToggle(digit);
+        model_.printRadixToggle(digit);
+        break;
+
+      case 9:
+        log(format("printRadixAll", mask % 3));
+        for (uint8_t i = 0; i < digits_; i++)
+        {
+          switch (mask % 3)
+          {
+            case 0:
+              model_.printRadixOn(i);
+              break;
+            case 1:
+              model_.printRadixOff(i);
+              break;
+            default:
+              model_.printRadixToggle(i);
+              break;
+          }
+        }
+        if (mask % 3 == 0)
+          disp_.printRadixOn();
+        else if (mask % 3 == 1)
+          disp_.printRadixOff();
+        else
+          disp_.printRadixToggle();
+        break;
+
+      case 10:
+        log(format("printText", text, digit));
+        disp_.printText(text.c_str(), digit);
+        model_.printText(text.c_str(), digit);
+        break;
+
+      case 11:
+        log(format("printGlyphs", text, digit));
+        disp_.printGlyphs(text.c_str(), digit);
+        model_.printGlyphs(text.c_str(), digit);
+        break;
+
+      case 12:
+        log(format("placePrint", digit));
+        disp_.placePrint(digit);
+        model_.placePrint(digit);
+        break;
+
+      case 13:
+        log(format("displayClear", digit));
+        disp_.displayClear(digit);
+        model_.displayClear(digit);
+        break;
+
+      case 14:
+        log(mask & 1 ? "display(reorder)" : "display()");
+        bus.take();
+        disp_.display(mask & 1 ? reorder_ : 0);
+        expected = model_.display(mask & 1 ? reorder_ : 0);
+        break;
+
+      default:
+        log(mask & 1 ? "displayUpdate(reorder)" : "displayUpdate()");
+        bus.take();
+        disp_.displayUpdate(mask & 1 ? reorder_ : 0);
+        expected = model_.displayUpdate(mask & 1 ? reorder_ : 0);
+        break;
+    }
+    return expected;
+  }
+
+  bool compare(const gbj_tm1637_model::Frames &expected)
+  {
+    gbj_tm1637_model::Frames actual = bus.take();
+    std::string error;
+    for (uint8_t digit = 0; digit <= digits_; digit++)
+    {
+      if (disp_.getSegments(digit) != model_.getSegments(digit))
+        error = "segments of digit " + std::to_string(digit);
+    }
+    if (disp_.getPrint() != model_.getPrint())
+      error = "print position";
+    if (actual != expected)
+      error = "bus bytes";
+    if (error.empty())
+      return true;
+    printf("digits %u, mismatch in %s after:\n", digits_, error.c_str());
+    for (size_t i = log_.size() > 20 ? log_.size() - 20 : 0; i < log_.size();
+         i++)
+    {
+      printf("  %s\n", log_[i].c_str());
+    }
+    printf("  library:");
+    dump(actual);
+    printf("  model:  ");
+    dump(expected);
+    return false;
+  }
+
+  void dump(const gbj_tm1637_model::Frames &frames)
+  {
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+      printf(" [");
+      for (size_t j = 0; j < frames[i].size(); j++)
+      {
+        printf("%s%02x", j ? " " : "", frames[i][j]);
+      }
+      printf("]");
+    }
+    printf("\n");
+  }
+};
+
+int main(int argc, char *argv[])
+{
+  uint32_t seed = argc > 1 ? strtoul(argv[1], 0, 0) : 1637;
+  uint16_t sequences = argc > 2 ? strtoul(argv[2], 0, 0) : 500;
+  for (uint16_t sequence = 0; sequence < sequences; sequence++)
+  {
+    uint8_t digits = 1 + sequence % GBJ_TM1637_DIGITS;
+    Runner runner(seed + sequence, digits);
+    if (!runner.run(200))
+    {
+      printf("FAILED: seed %u, sequence %u\n", seed, sequence);
+      return 1;
+    }
+  }
+  printf("PASSED: seed %u, %u sequences\n", seed, sequences);
+  return 0;
+}
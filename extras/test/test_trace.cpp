@@ -0,0 +1,109 @@
+/**
+ * @file test_trace.cpp
+ * @brief Host check of the bus trace recorder and its VCD export.
+ * @details The test records pin activity of the method display() by the
+ * recorder from the include file extras/gbj_tm1637_trace.h and checks the
+ * exported Value Change Dump for decoded commands, data bytes, acknowledges,
+ * and decimal timestamps.
+ * @details Build and run on a host from the library root folder:
+ *
+ *     g++ -std=c++11 -Wall -Wextra -I extras/test -I src \
+ *       extras/test/test_trace.cpp -o test_trace
+ *     ./test_trace
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#include <Arduino.h>
+#include <string>
+
+#include "../gbj_tm1637_trace.h"
+#include "gbj_tm1637.h"
+#include "../font7seg_basic.h"
+
+/**
+ * @brief Output stream collecting the export in a string.
+ */
+class Capture : public Print
+{
+public:
+  std::string text;
+
+  size_t write(uint8_t ascii)
+  {
+    text += (char)ascii;
+    return 1;
+  }
+};
+
+unsigned count(const std::string &text, const std::string &pattern)
+{
+  unsigned found = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + 1))
+  {
+    found++;
+  }
+  return found;
+}
+
+/**
+ * @brief Check that every timestamp line is a decimal number.
+ */
+bool isTimeDecimal(const std::string &text)
+{
+  unsigned lines = 0;
+  for (size_t pos = text.find("\n#"); pos != std::string::npos;
+       pos = text.find("\n#", pos + 1))
+  {
+    size_t end = text.find('\n', pos + 1);
+    std::string time = text.substr(pos + 2, end - pos - 2);
+    if (time.empty() ||
+        time.find_first_not_of("0123456789") != std::string::npos)
+      return false;
+    lines++;
+  }
+  return lines > 1;
+}
+
+int main()
+{
+  const uint8_t digits = 4;
+  gbj_tm1637 disp(2, 3, digits);
+  disp.setFont(gbjFont7segTable, sizeof(gbjFont7segTable));
+  disp.begin();
+  disp.printText("12");
+  gbj_tm1637_trace::clear();
+  disp.display();
+  Capture vcd;
+  gbj_tm1637_trace::exportVcd(vcd, 2, 3);
+
+  const char *failure = 0;
+  if (gbj_tm1637_trace::isOverflow())
+    failure = "event buffer overflow";
+  else if (count(vcd.text, "$comment command 0x40 $end") != 1)
+    failure = "data command";
+  else if (count(vcd.text, "$comment command 0xC0 $end") != 1)
+    failure = "address command";
+  else if (count(vcd.text, "$comment data 0x") != digits)
+    failure = "data bytes";
+  else if (count(vcd.text, "$comment ack $end") != 2 + digits)
+    failure = "acknowledges";
+  else if (count(vcd.text, "$comment start $end") != 2 ||
+           count(vcd.text, "$comment stop $end") != 2)
+    failure = "frames";
+  else if (!isTimeDecimal(vcd.text))
+    failure = "timestamps";
+  if (failure)
+  {
+    printf("%s\nFAILED: %s\n", vcd.text.c_str(), failure);
+    return 1;
+  }
+  printf("PASSED: %u events\n", gbj_tm1637_trace::getEvents());
+  return 0;
+}
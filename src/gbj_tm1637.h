@@ -29,11 +29,46 @@
   #include <Arduino.h>
 #endif
 
+/**
+ * @brief Optional hook for recording pin activity on the serial bus.
+ * @details A sketch or host harness can define this macro before including
+ * the library header in order to capture every mode change, write, and read
+ * on the clock and data pins, e.g., by the recorder from the include file
+ * extras/gbj_tm1637_trace.h. The event is 'm' for pin mode, 'w' for written
+ * level, and 'r' for read level.
+ */
+#ifndef GBJ_TM1637_TRACE
+  #define GBJ_TM1637_TRACE(pin, event, value)
+#endif
+
+/**
+ * @brief Compact configuration for many instances on memory limited boards.
+ * @details GBJ_TM1637_DIGITS sizes the screen buffer to the maximal digit
+ * count actually used, e.g., 4 for TM1636 modules.
+ * @details GBJ_TM1637_FONT_SHARED stores one font descriptor for all
+ * instances instead of one per instance.
+ * @details GBJ_TM1637_NO_PRINT drops the inheritance from the system class
+ * Print with its virtual table, so that only the write() methods and the
+ * printing wrappers of the library are available.
+ * @details The macros change the class layout, so that they must have the
+ * same values in all translation units.
+ */
+#ifndef GBJ_TM1637_DIGITS
+  #define GBJ_TM1637_DIGITS 6
+#endif
+// Controller addresses 6 digits and the status stores up to 7 in 3 bits
+#if GBJ_TM1637_DIGITS < 1 || GBJ_TM1637_DIGITS > 6
+  #error "GBJ_TM1637_DIGITS must be in range 1 to 6"
+#endif
+
 /**
  * @class gbj_tm1637
  * @brief TM1637/TM1636 7-segment display driver.
  */
-class gbj_tm1637 : public Print
+class gbj_tm1637
+#if !defined(GBJ_TM1637_NO_PRINT)
+  : public Print
+#endif
 {
 public:
   enum ResultCodes : uint8_t
@@ -41,6 +76,59 @@ public:
     SUCCESS = 0,
     ERROR_PINS,
     ERROR_ACK,
+    ERROR_BUDGET,
+  };
+
+  /**
+   * @brief Alignment of text within a field.
+   */
+  enum FieldAlign : uint8_t
+  {
+    /** @brief Text starts at the first digit, padding follows it. */
+    ALIGN_LEFT,
+    /** @brief Text ends at the last digit, padding precedes it. */
+    ALIGN_RIGHT,
+  };
+
+  /**
+   * @brief Handling of radix segments within a field.
+   */
+  enum FieldRadix : uint8_t
+  {
+    /** @brief Radix segments stay untouched, radix markers are ignored. */
+    RADIX_KEEP,
+    /** @brief Radix segments are set by radix markers in text only. */
+    RADIX_TEXT,
+  };
+
+  /**
+   * @brief Fixed screen area rendered independently of the rest.
+   */
+  struct Field
+  {
+    /** @brief First digit index of the field. */
+    uint8_t digit;
+    /** @brief Number of digits of the field. */
+    uint8_t width;
+    /** @brief Alignment of text within the field. */
+    FieldAlign align;
+    /** @brief Character filling unused digits of the field. */
+    char padding;
+    /** @brief Handling of radix segments. */
+    FieldRadix radix;
+  };
+
+  /**
+   * @brief Displayed content and state for restoring after restart.
+   */
+  struct Snapshot
+  {
+    /** @brief Segment masks of digits including radix segments. */
+    uint8_t frame[GBJ_TM1637_DIGITS];
+    /** @brief Contrast level. */
+    uint8_t contrast;
+    /** @brief Flag about display turned on. */
+    bool state;
   };
 
   /**
@@ -55,6 +143,17 @@ public:
     status_.pinClk = pinClk;
     status_.pinDio = pinDio;
     status_.digits = min(digits, (uint8_t)Geometry::DIGITS);
+    status_.state = true;
+    status_.blank = false;
+    blink_.digits = 0;
+    blink_.radixes = 0;
+    blink_.changed = 0;
+    blink_.period = 1000;
+    blink_.phase = 0;
+    status_.timeCommand = Timing::TIMING_COMMAND;
+    status_.flush = 0;
+    // Controller memory content is unknown until the first transmission
+    print_.dirty = (1 << status_.digits) - 1;
   }
 
   /**
@@ -68,10 +167,46 @@ public:
     setLastResult();
     if (status_.pinClk == status_.pinDio)
       return setLastResult(ResultCodes::ERROR_PINS);
-    pinMode(status_.pinClk, OUTPUT);
-    pinMode(status_.pinDio, OUTPUT);
+    pinSetMode(status_.pinClk, OUTPUT);
+    pinSetMode(status_.pinDio, OUTPUT);
     displayClear();
-    return setContrast();
+    // Command transaction seeds its duration for budgeted transmission
+    uint32_t tsStart = micros();
+    if (setContrast())
+      return getLastResult();
+    status_.timeCommand = micros() - tsStart;
+    return getLastResult();
+  }
+
+  /**
+   * @brief Initialize the display driver with restored content and state.
+   * @details The screen buffer is loaded from the snapshot instead of being
+   * cleared, and the frame is transmitted before the display control
+   * command, so that the display shows the restored content right away
+   * without a visible clear.
+   * @param snapshot Content and state acquired by getSnapshot().
+   * @return Result code of the initialization sequence.
+   */
+  inline ResultCodes begin(const Snapshot &snapshot)
+  {
+    setLastResult();
+    if (status_.pinClk == status_.pinDio)
+      return setLastResult(ResultCodes::ERROR_PINS);
+    pinSetMode(status_.pinClk, OUTPUT);
+    pinSetMode(status_.pinDio, OUTPUT);
+    for (uint8_t digit = 0; digit < status_.digits; digit++)
+    {
+      print_.buffer[digit] = snapshot.frame[digit];
+    }
+    print_.digit = 0;
+    status_.contrast = snapshot.contrast & getContrastMax();
+    if (display())
+      return getLastResult();
+    uint32_t tsStart = micros();
+    if (snapshot.state ? displayOn() : displayOff())
+      return getLastResult();
+    status_.timeCommand = micros() - tsStart;
+    return getLastResult();
   }
 
   /**
@@ -87,12 +222,108 @@ public:
     if (busSend(Commands::CMD_DATA_INIT | Commands::CMD_DATA_NORMAL |
                 Commands::CMD_DATA_WRITE | Commands::CMD_DATA_AUTO))
       return getLastResult();
-    if (busSend(
-          Commands::CMD_ADDR_INIT, print_.buffer, status_.digits, digitReorder))
+    if (busSend(Commands::CMD_ADDR_INIT, 0, status_.digits, digitReorder))
+      return getLastResult();
+    print_.dirty = 0;
+    blink_.changed = 0;
+    return getLastResult();
+  }
+
+  /**
+   * @brief Transmit the screen buffer within a time budget.
+   * @details The method transmits as many whole bytes as fit into the budget
+   * and remembers the next display position, from which it continues at the
+   * next call in automatic addressing mode. Every call ends with stop
+   * condition, so that the bus is never left in the middle of a byte. The
+   * duration of a whole command transaction is measured at runtime, first at
+   * begin() and then at every data command. Until then a conservative
+   * estimate is used. A data byte with the stop condition never takes longer
+   * than a command transaction, so that the budget is not exceeded.
+   * @param budgetMicros Time budget in microseconds.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   * @return Result code of the transmission, or ERROR_BUDGET if the budget
+   * does not cover both commands with at least one data byte.
+   */
+  inline ResultCodes displayBudget(uint16_t budgetMicros,
+                                   uint8_t *digitReorder = 0)
+  {
+    uint32_t tsStart = micros();
+    setLastResult();
+    // Data command, address command, and one data byte with stop condition
+    if (budgetMicros < 3 * (uint32_t)status_.timeCommand)
+      return setLastResult(ResultCodes::ERROR_BUDGET);
+    if (busSend(Commands::CMD_DATA_INIT | Commands::CMD_DATA_NORMAL |
+                Commands::CMD_DATA_WRITE | Commands::CMD_DATA_AUTO))
+      return getLastResult();
+    status_.timeCommand = micros() - tsStart;
+    if (micros() - tsStart + 2 * (uint32_t)status_.timeCommand > budgetMicros)
+      return setLastResult(ResultCodes::ERROR_BUDGET);
+    beginTransmission();
+    busWrite(setLastCommand(Commands::CMD_ADDR_INIT | status_.flush));
+    if (ackTransmission())
+    {
+      endTransmission();
       return getLastResult();
+    }
+    // Next data byte with stop condition takes at most a command transaction
+    while (status_.flush < status_.digits &&
+           micros() - tsStart + status_.timeCommand <= budgetMicros)
+    {
+      uint8_t digit = getDigitAt(status_.flush, digitReorder);
+      busWrite(getFrameByte(digit));
+      if (ackTransmission())
+        break;
+      print_.dirty &= ~(1 << digit);
+      blink_.changed &= ~(1 << digit);
+      status_.flush++;
+    }
+    endTransmission();
+    if (status_.flush >= status_.digits)
+      status_.flush = 0;
     return getLastResult();
   }
 
+  /**
+   * @brief Transmit only changed digits of the screen buffer.
+   * @details Digits changed since their recent transmission are sent in
+   * automatic addressing mode, every contiguous run of them in the display
+   * order within one address command. Nothing is sent without changes.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   * @return Result code of the transmission.
+   */
+  inline ResultCodes displayUpdate(uint8_t *digitReorder = 0)
+  {
+    setLastResult();
+    if (!print_.dirty)
+      return getLastResult();
+    return busSendDigits(print_.dirty, digitReorder);
+  }
+
+  /**
+   * @brief Apply blinking attributes to the display.
+   * @details The method should be called from the main loop. At every change
+   * of blinking phase it transmits only digits with blinking attributes. Digits
+   * with attributes changed since their recent transmission are sent right
+   * away, so that a digit with cleared attribute is not left dark. The
+   * screen buffer content stays untouched, blinking segments are just masked
+   * in transmitted data.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   * @return Result code of the transmission, or SUCCESS without one.
+   */
+  inline ResultCodes displayBlink(uint8_t *digitReorder = 0)
+  {
+    setLastResult();
+    uint8_t digitMask = blink_.changed;
+    if (printBlink())
+      digitMask |= blink_.digits | blink_.radixes;
+    if (!digitMask)
+      return getLastResult();
+    return busSendDigits(digitMask, digitReorder);
+  }
+
   /**
    * @brief Turn the display output on or off.
    * @details These methods change global display state without modifying the
@@ -154,7 +385,7 @@ public:
   inline void printRadixOn(uint8_t digit)
   {
     if (digit < status_.digits)
-      print_.buffer[digit] |= 0x80;
+      bufferWrite(digit, print_.buffer[digit] | 0x80);
   }
 
   /**
@@ -173,7 +404,7 @@ public:
   inline void printRadixOff(uint8_t digit)
   {
     if (digit < status_.digits)
-      print_.buffer[digit] &= ~0x80;
+      bufferWrite(digit, print_.buffer[digit] & ~0x80);
   }
 
   /**
@@ -192,7 +423,7 @@ public:
   inline void printRadixToggle(uint8_t digit)
   {
     if (digit < status_.digits)
-      print_.buffer[digit] ^= 0x80;
+      bufferWrite(digit, print_.buffer[digit] ^ 0x80);
   }
 
   /**
@@ -265,7 +496,7 @@ public:
   inline void printText(const char *text, uint8_t digit = 0)
   {
     displayClear(digit);
-    print(text);
+    write(text);
   };
 
   /**
@@ -276,7 +507,7 @@ public:
   inline void printText(String text, uint8_t digit = 0)
   {
     displayClear(digit);
-    print(text);
+    write(text.c_str());
   };
 
   /**
@@ -288,7 +519,7 @@ public:
   {
     printDigitOff();
     placePrint(digit);
-    print(text);
+    write(text);
   };
 
   /**
@@ -300,9 +531,104 @@ public:
   {
     printDigitOff();
     placePrint(digit);
-    print(text);
+    write(text.c_str());
   };
 
+  /**
+   * @brief Print text into a field without influence on the rest of screen.
+   * @details The text is rendered into the field's digits with alignment and
+   * padding, clipped to the field width. Only digits whose content actually
+   * changes are marked for the method displayUpdate(). The print position
+   * is set right after the field.
+   * @param field Field descriptor.
+   * @param text Text to print.
+   */
+  inline void printField(const Field &field, const char *text)
+  {
+    if (field.digit >= status_.digits)
+      return;
+    uint8_t frame[Geometry::DIGITS];
+    uint8_t width = getFieldWidth(field);
+    uint8_t padding = getFontMask(field.padding);
+    if (padding == Rasters::FONT_MASK_WRONG)
+      padding = 0x00;
+    size_t glyphs = 0;
+    for (size_t i = 0; text[i] != '\0'; i++)
+    {
+      if (getFontMask(text[i]) != Rasters::FONT_MASK_WRONG)
+        glyphs++;
+    }
+    uint8_t slotStart = 0;
+    if (field.align == FieldAlign::ALIGN_RIGHT && glyphs < width)
+      slotStart = width - glyphs;
+    for (uint8_t slot = 0; slot < width; slot++)
+    {
+      frame[slot] = padding;
+    }
+    uint8_t slot = slotStart;
+    for (size_t i = 0; text[i] != '\0'; i++)
+    {
+      uint8_t mask = getFontMask(text[i]);
+      if (mask == Rasters::FONT_MASK_WRONG)
+      {
+        if (slot > slotStart && isRadixMarker(text[i]))
+          frame[slot - 1] |= 0x80;
+        continue;
+      }
+      if (slot >= width)
+        break;
+      frame[slot++] = mask;
+    }
+    for (slot = 0; slot < width; slot++)
+    {
+      uint8_t digit = field.digit + slot;
+      printDigit(frame[slot], digit);
+      if (field.radix == FieldRadix::RADIX_KEEP)
+        continue;
+      if (frame[slot] & 0x80)
+      {
+        printRadixOn(digit);
+      }
+      else
+      {
+        printRadixOff(digit);
+      }
+    }
+  }
+
+  /**
+   * @brief Print String text into a field.
+   * @param field Field descriptor.
+   * @param text Text to print.
+   */
+  inline void printField(const Field &field, String text)
+  {
+    printField(field, text.c_str());
+  }
+
+  /**
+   * @brief Print decimal integer into a field.
+   * @details A number wider than the field is rendered as dashes in all
+   * digits of the field, so that a wrong magnitude is never displayed.
+   * @param field Field descriptor.
+   * @param value Number to print.
+   */
+  inline void printField(const Field &field, long value)
+  {
+    char text[12];
+    ltoa(value, text, 10);
+    uint8_t width = getFieldWidth(field);
+    if (strlen(text) > width)
+    {
+      for (uint8_t i = 0; i < width; i++)
+      {
+        text[i] = '-';
+      }
+      text[width] = '\0';
+    }
+    printField(field, text);
+  }
+
   /**
    * @brief Write one character to the current print position.
    * @details Unknown glyphs are ignored. Characters '.', ',', and ':' are
@@ -312,22 +638,19 @@ public:
    */
   inline size_t write(uint8_t ascii)
   {
-    if (print_.digit >= status_.digits)
-      return 0;
     uint8_t mask = getFontMask(ascii);
     if (mask == Rasters::FONT_MASK_WRONG)
     {
-      if (String(".,:").indexOf(ascii) >= 0)
+      if (isRadixMarker(ascii))
       {
         printRadixOn(print_.digit - 1);
       }
       return 0;
     }
-    else
-    {
-      printDigit(mask, print_.digit);
-      return 1;
-    }
+    if (print_.digit >= status_.digits)
+      return 0;
+    printDigit(mask, print_.digit);
+    return 1;
   }
 
   /**
@@ -338,8 +661,10 @@ public:
   inline size_t write(const char *text)
   {
     uint8_t digits = 0;
-    uint8_t i = 0;
-    while (text[i] != '\0' && print_.digit < status_.digits)
+    size_t i = 0;
+    // Radix marker right after the last digit still belongs to it
+    while (text[i] != '\0' &&
+           (print_.digit < status_.digits || isRadixMarker(text[i])))
     {
       digits += write(text[i++]);
     }
@@ -355,8 +680,10 @@ public:
   inline size_t write(const uint8_t *buffer, size_t size)
   {
     uint8_t digits = 0;
-    for (uint8_t i = 0; i < size && print_.digit < status_.digits; i++)
+    for (size_t i = 0; i < size; i++)
     {
+      if (print_.digit >= status_.digits && !isRadixMarker(buffer[i]))
+        break;
       digits += write(buffer[i]);
     }
     return digits;
@@ -369,7 +696,7 @@ public:
    */
   inline ResultCodes setLastResult(ResultCodes result = ResultCodes::SUCCESS)
   {
-    return status_.lastResult = result;
+    return (ResultCodes)(status_.lastResult = result);
   };
 
   /**
@@ -404,15 +731,93 @@ public:
    */
   inline void setFont(const uint8_t *fontTable, uint8_t fontTableSize)
   {
-    font_.table = fontTable;
-    font_.glyphs = fontTableSize / Rasters::FONT_WIDTH;
+    getFont().table = fontTable;
+    getFont().glyphs = fontTableSize / Rasters::FONT_WIDTH;
+  }
+
+  /**
+   * @brief Set blinking period and phase.
+   * @details Blinking segments are turned off in the second half of the
+   * period.
+   * @param period Blinking period in milliseconds.
+   * @param phase Time shift of the period in milliseconds.
+   */
+  inline void setBlink(uint16_t period = 1000, uint16_t phase = 0)
+  {
+    blink_.period = period;
+    blink_.phase = phase;
+  }
+
+  /**
+   * @brief Set or clear blinking attribute of glyph segments of a digit.
+   * @details Blinking attributes are applied by the method displayBlink()
+   * without changing the screen buffer.
+   * @param digit Target digit index.
+   */
+  inline void blinkDigitOn(uint8_t digit)
+  {
+    if (digit < status_.digits)
+      blinkWrite(blink_.digits, blink_.digits | (1 << digit));
+  }
+  inline void blinkDigitOff(uint8_t digit)
+  {
+    if (digit < status_.digits)
+      blinkWrite(blink_.digits, blink_.digits & ~(1 << digit));
+  }
+
+  /**
+   * @brief Clear blinking attributes of glyph segments of all digits.
+   */
+  inline void blinkDigitOff() { blinkWrite(blink_.digits, 0); }
+
+  /**
+   * @brief Set or clear blinking attribute of radix segment of a digit.
+   * @param digit Target digit index.
+   */
+  inline void blinkRadixOn(uint8_t digit)
+  {
+    if (digit < status_.digits)
+      blinkWrite(blink_.radixes, blink_.radixes | (1 << digit));
+  }
+  inline void blinkRadixOff(uint8_t digit)
+  {
+    if (digit < status_.digits)
+      blinkWrite(blink_.radixes, blink_.radixes & ~(1 << digit));
+  }
+
+  /**
+   * @brief Clear blinking attributes of radix segments of all digits.
+   */
+  inline void blinkRadixOff() { blinkWrite(blink_.radixes, 0); }
+
+  /**
+   * @brief Follow blinking phase without transmission.
+   * @details At every change of blinking phase the digits with blinking
+   * attributes are marked as changed, so that the next displayUpdate()
+   * transmits them together with other changed digits.
+   * @return True if the blinking phase has changed.
+   */
+  inline bool printBlink()
+  {
+    uint8_t digitMask = blink_.digits | blink_.radixes;
+    bool blank = digitMask && blink_.period &&
+                 (millis() + blink_.phase) % blink_.period >=
+                   blink_.period / 2;
+    if (blank == status_.blank)
+      return false;
+    status_.blank = blank;
+    print_.dirty |= digitMask;
+    return true;
   }
 
   /**
    * @brief Get latest operation result code.
    * @return Last stored result code.
    */
-  inline ResultCodes getLastResult() { return status_.lastResult; }
+  inline ResultCodes getLastResult()
+  {
+    return (ResultCodes)status_.lastResult;
+  }
 
   /**
    * @brief Check whether latest operation result is success.
@@ -460,6 +865,19 @@ public:
    */
   inline bool isDisplayOff() { return !isDisplayOn(); }
 
+  /**
+   * @brief Check whether some digits wait for transmission.
+   * @return True if the screen buffer has been changed since recent
+   * transmission.
+   */
+  inline bool isDisplayChanged() { return print_.dirty; }
+
+  /**
+   * @brief Check whether a budgeted transmission has not finished yet.
+   * @return True if the method displayBudget() stopped inside the buffer.
+   */
+  inline bool isDisplayFlushing() { return status_.flush; }
+
   /**
    * @brief Get last command value sent to controller.
    * @return Last command byte.
@@ -484,6 +902,27 @@ public:
     return Geometry::DIGITS;
   }
 
+  /**
+   * @brief Get operating memory occupied by one instance.
+   * @details The footprint depends on the compact configuration macros and
+   * does not include the shared font descriptor.
+   * @return Size of the instance object in bytes.
+   */
+  static inline size_t getFootprint() { return sizeof(gbj_tm1637); }
+
+  /**
+   * @brief Get time until the next change of blinking phase.
+   * @return Time in milliseconds, or 0xFFFF without blinking attributes.
+   */
+  inline uint16_t getBlinkWait()
+  {
+    if (!(blink_.digits | blink_.radixes) || !blink_.period)
+      return 0xFFFF;
+    uint16_t half = blink_.period / 2;
+    uint16_t position = (millis() + blink_.phase) % blink_.period;
+    return position < half ? half - position : blink_.period - position;
+  }
+
   /**
    * @brief Get current contrast level.
    * @return Contrast value in range 0 to 7.
@@ -502,6 +941,34 @@ public:
    */
   static inline uint8_t getContrastMin() { return 0; }
 
+  /**
+   * @brief Get segment mask of a digit from the screen buffer.
+   * @param digit Digit index.
+   * @return Segment mask including radix segment, or 0 for wrong digit.
+   */
+  inline uint8_t getSegments(uint8_t digit)
+  {
+    return digit < status_.digits ? print_.buffer[digit] : 0x00;
+  }
+
+  /**
+   * @brief Get displayed content and state for restoring after restart.
+   * @details The frame is the current screen buffer, so that the snapshot
+   * should be acquired after transmission.
+   * @return Snapshot of screen buffer, contrast, and display state.
+   */
+  inline Snapshot getSnapshot()
+  {
+    Snapshot snapshot;
+    for (uint8_t digit = 0; digit < Geometry::DIGITS; digit++)
+    {
+      snapshot.frame[digit] = getSegments(digit);
+    }
+    snapshot.contrast = status_.contrast;
+    snapshot.state = status_.state;
+    return snapshot;
+  }
+
   /**
    * @brief Get current print cursor position.
    * @return Current digit index for subsequent print operations.
@@ -549,7 +1016,7 @@ private:
   enum Geometry : uint8_t
   {
     /** @brief Maximum supported digit count. */
-    DIGITS = 6,
+    DIGITS = GBJ_TM1637_DIGITS,
     /** @brief Maximum addressable bytes in TM1637 display RAM. */
     BYTES_ADDR = 6,
   };
@@ -563,6 +1030,8 @@ private:
     TIMING_RELAX = 2,
     /** @brief Acknowledge timeout in microseconds. */
     TIMING_ACK = 500,
+    /** @brief Upper estimate of a command transaction until it is measured. */
+    TIMING_COMMAND = 2 * TIMING_ACK,
   };
 
   /**
@@ -586,11 +1055,30 @@ private:
   struct Print
   {
     /** @brief Segment masks for each display position. */
-    uint8_t buffer[Geometry::BYTES_ADDR];
+    uint8_t buffer[Geometry::DIGITS];
     /** @brief Current print cursor position. */
     uint8_t digit;
+    /** @brief Bit mask of digits changed since recent transmission. */
+    uint8_t dirty;
   } print_;
 
+  /**
+   * @brief Blinking attributes.
+   */
+  struct Blink
+  {
+    /** @brief Bit mask of digits with blinking glyph segments. */
+    uint8_t digits;
+    /** @brief Bit mask of digits with blinking radix segment. */
+    uint8_t radixes;
+    /** @brief Bit mask of digits with attributes changed since transmission. */
+    uint8_t changed;
+    /** @brief Blinking period in milliseconds. */
+    uint16_t period;
+    /** @brief Time shift of blinking period in milliseconds. */
+    uint16_t phase;
+  } blink_;
+
   /**
    * @brief Active font table descriptor.
    */
@@ -600,27 +1088,55 @@ private:
     const uint8_t *table;
     /** @brief Number of glyph entries available in the table. */
     uint8_t glyphs;
-  } font_;
+  };
+
+#if defined(GBJ_TM1637_FONT_SHARED)
+  /**
+   * @brief Get font descriptor shared by all instances.
+   * @return Reference to the font descriptor.
+   */
+  static inline Bitmap &getFont()
+  {
+    static Bitmap font;
+    return font;
+  }
+#else
+  /** @brief Active font table descriptor of the instance. */
+  Bitmap font_;
+
+  /**
+   * @brief Get font descriptor of the instance.
+   * @return Reference to the font descriptor.
+   */
+  inline Bitmap &getFont() { return font_; }
+#endif
 
   /**
    * @brief Driver status and hardware configuration.
+   * @details Small values are packed into bit fields.
    */
   struct Status
   {
-    /** @brief Result of the most recent operation. */
-    ResultCodes lastResult;
     /** @brief Most recently sent command byte. */
     uint8_t lastCommand;
     /** @brief Clock pin number. */
     uint8_t pinClk;
     /** @brief Data pin number. */
     uint8_t pinDio;
+    /** @brief Measured duration of a command transaction in microseconds. */
+    uint16_t timeCommand;
+    /** @brief Result of the most recent operation. */
+    uint8_t lastResult : 2;
     /** @brief Active digit count. */
-    uint8_t digits;
+    uint8_t digits : 3;
     /** @brief Current display contrast level. */
-    uint8_t contrast;
+    uint8_t contrast : 3;
     /** @brief Current display power state. */
-    bool state = true;
+    bool state : 1;
+    /** @brief Flag about blinking segments being turned off. */
+    bool blank : 1;
+    /** @brief Next display position of budgeted transmission. */
+    uint8_t flush : 3;
   } status_;
 
   /**
@@ -628,7 +1144,7 @@ private:
    * @param a First value.
    * @param b Second value.
    */
-  inline void swapByte(uint8_t a, uint8_t b)
+  inline void swapByte(uint8_t &a, uint8_t &b)
   {
     if (a > b)
     {
@@ -638,6 +1154,28 @@ private:
     }
   };
 
+  /**
+   * @brief Get number of digits of a field within the display.
+   * @param field Field descriptor.
+   * @return Field width clipped by the display, 0 for a field beyond it.
+   */
+  inline uint8_t getFieldWidth(const Field &field)
+  {
+    if (field.digit >= status_.digits)
+      return 0;
+    return min(field.width, (uint8_t)(status_.digits - field.digit));
+  }
+
+  /**
+   * @brief Check whether a character is a radix marker.
+   * @param ascii ASCII code of the character.
+   * @return True for dot, comma, and colon.
+   */
+  static inline bool isRadixMarker(uint8_t ascii)
+  {
+    return ascii == '.' || ascii == ',' || ascii == ':';
+  }
+
   /**
    * @brief Store command byte as latest command.
    * @param lastCommand Command byte to store.
@@ -648,6 +1186,40 @@ private:
     return status_.lastCommand = lastCommand;
   };
 
+  /**
+   * @brief Set mode of a bus pin.
+   * @param pin Pin number.
+   * @param mode Pin mode.
+   */
+  inline void pinSetMode(uint8_t pin, uint8_t mode)
+  {
+    pinMode(pin, mode);
+    GBJ_TM1637_TRACE(pin, 'm', mode);
+  }
+
+  /**
+   * @brief Write logical level to a bus pin.
+   * @param pin Pin number.
+   * @param level Logical level.
+   */
+  inline void pinWrite(uint8_t pin, uint8_t level)
+  {
+    digitalWrite(pin, level);
+    GBJ_TM1637_TRACE(pin, 'w', level);
+  }
+
+  /**
+   * @brief Read logical level of a bus pin.
+   * @param pin Pin number.
+   * @return Logical level.
+   */
+  inline uint8_t pinRead(uint8_t pin)
+  {
+    uint8_t level = digitalRead(pin);
+    GBJ_TM1637_TRACE(pin, 'r', level);
+    return level;
+  }
+
   /**
    * @brief Wait one timing slot for clock pulse relaxation.
    */
@@ -661,10 +1233,10 @@ private:
    */
   inline void beginTransmission()
   {
-    digitalWrite(status_.pinClk, LOW);
-    digitalWrite(status_.pinDio, HIGH);
-    digitalWrite(status_.pinClk, HIGH);
-    digitalWrite(status_.pinDio, LOW);
+    pinWrite(status_.pinClk, LOW);
+    pinWrite(status_.pinDio, HIGH);
+    pinWrite(status_.pinClk, HIGH);
+    pinWrite(status_.pinDio, LOW);
   }
 
   /**
@@ -672,20 +1244,98 @@ private:
    */
   inline void endTransmission()
   {
-    digitalWrite(status_.pinClk, LOW);
-    digitalWrite(status_.pinDio, LOW);
-    digitalWrite(status_.pinClk, HIGH);
-    digitalWrite(status_.pinDio, HIGH);
+    pinWrite(status_.pinClk, LOW);
+    pinWrite(status_.pinDio, LOW);
+    pinWrite(status_.pinClk, HIGH);
+    pinWrite(status_.pinDio, HIGH);
   }
 
   /**
    * @brief Write one byte on the TM1637 serial bus.
+   * @details Bits are shifted out from LSB like with shiftOut(), but through
+   * the pin primitives, so that they can be traced.
    * @param data Byte to transmit.
    */
   inline void busWrite(uint8_t data)
   {
-    digitalWrite(status_.pinClk, LOW);
-    shiftOut(status_.pinDio, status_.pinClk, LSBFIRST, data);
+    pinWrite(status_.pinClk, LOW);
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+      pinWrite(status_.pinDio, data & 0x01);
+      pinWrite(status_.pinClk, HIGH);
+      pinWrite(status_.pinClk, LOW);
+      data >>= 1;
+    }
+  }
+
+  /**
+   * @brief Store a value to the screen buffer and mark a change of it.
+   * @param digit Target digit index.
+   * @param data Segment mask including radix segment.
+   */
+  inline void bufferWrite(uint8_t digit, uint8_t data)
+  {
+    if (print_.buffer[digit] != data)
+    {
+      print_.buffer[digit] = data;
+      print_.dirty |= 1 << digit;
+    }
+  }
+
+  /**
+   * @brief Get screen buffer index transmitted to a display position.
+   * @param address Display position.
+   * @param transform Optional transformation table for digit order.
+   * @return Screen buffer index.
+   */
+  inline uint8_t getDigitAt(uint8_t address, uint8_t *transform)
+  {
+    return transform ? transform[address] : address;
+  }
+
+  /**
+   * @brief Check whether digit at a display position is in a digit mask.
+   * @param digitMask Bit mask of screen buffer indexes.
+   * @param address Display position.
+   * @param transform Optional transformation table for digit order.
+   * @return True if the digit is in the mask.
+   */
+  inline bool isDigitIn(uint8_t digitMask, uint8_t address, uint8_t *transform)
+  {
+    return digitMask & (1 << getDigitAt(address, transform));
+  }
+
+  /**
+   * @brief Get transmitted segment mask of a digit.
+   * @details Blinking segments are masked out in the blank blinking phase.
+   * @param digit Screen buffer index.
+   * @return Segment mask including radix segment.
+   */
+  inline uint8_t getFrameByte(uint8_t digit)
+  {
+    uint8_t data = print_.buffer[digit];
+    if (status_.blank)
+    {
+      if (blink_.digits & (1 << digit))
+        data &= 0x80;
+      if (blink_.radixes & (1 << digit))
+        data &= 0x7F;
+    }
+    return data;
+  }
+
+  /**
+   * @brief Change a blinking attribute mask and mark affected digits.
+   * @details Digits with changed attribute are marked as changed, so that
+   * they are transmitted with correct blinking state at the next update.
+   * @param mask Blinking attribute mask to be changed.
+   * @param value New value of the mask.
+   */
+  inline void blinkWrite(uint8_t &mask, uint8_t value)
+  {
+    blink_.changed |= mask ^ value;
+    print_.dirty |= mask ^ value;
+    mask = value;
   }
 
   /**
@@ -703,9 +1353,8 @@ private:
     for (print_.digit = gridStart; print_.digit <= gridStop; print_.digit++)
     {
       segmentMask &= 0x7F;
-      print_.buffer[print_.digit] &= 0x80;
-      print_.buffer[print_.digit] |=
-        segmentMask;
+      bufferWrite(print_.digit,
+                  (print_.buffer[print_.digit] & 0x80) | segmentMask);
     }
   }
 
@@ -716,20 +1365,20 @@ private:
   inline ResultCodes ackTransmission()
   {
     setLastResult();
-    pinMode(status_.pinDio, INPUT_PULLUP);
-    digitalWrite(status_.pinClk, HIGH);
+    pinSetMode(status_.pinDio, INPUT_PULLUP);
+    pinWrite(status_.pinClk, HIGH);
     uint32_t tsStart = micros();
-    while (digitalRead(status_.pinDio))
+    while (pinRead(status_.pinDio))
     {
-      if (millis() - tsStart > Timing::TIMING_ACK)
+      if (micros() - tsStart > Timing::TIMING_ACK)
       {
         setLastResult(ResultCodes::ERROR_ACK);
         break;
       }
     }
-    digitalWrite(status_.pinClk, LOW);
-    digitalWrite(status_.pinDio, LOW);
-    pinMode(status_.pinDio, OUTPUT);
+    pinWrite(status_.pinClk, LOW);
+    pinWrite(status_.pinDio, LOW);
+    pinSetMode(status_.pinDio, OUTPUT);
     return getLastResult();
   }
 
@@ -769,17 +1418,18 @@ private:
   }
 
   /**
-   * @brief Send command and data stream with optional digit reordering.
+   * @brief Send command and screen buffer stream with optional digit
+   * reordering.
    * @param command Command byte.
-   * @param buffer Pointer to data buffer.
+   * @param bufferStart Display position of the first sent byte.
    * @param bufferBytes Number of bytes to send.
    * @param transform Optional transformation table for digit order.
    * @return Result code of transfer.
    */
   inline ResultCodes busSend(uint8_t command,
-                             uint8_t *buffer,
+                             uint8_t bufferStart,
                              uint8_t bufferBytes,
-                             uint8_t *transform = 0)
+                             uint8_t *transform)
   {
     beginTransmission();
     busWrite(setLastCommand(command));
@@ -788,20 +1438,58 @@ private:
       endTransmission();
       return getLastResult();
     };
-    for (uint8_t bufferIndex = 0; bufferIndex < bufferBytes; bufferIndex++)
+    for (uint8_t bufferIndex = bufferStart;
+         bufferIndex < bufferStart + bufferBytes;
+         bufferIndex++)
     {
-      if (transform)
+      busWrite(getFrameByte(getDigitAt(bufferIndex, transform)));
+      if (ackTransmission())
+        break;
+    }
+    endTransmission();
+    return getLastResult();
+  }
+
+  /**
+   * @brief Send selected digits of the screen buffer.
+   * @details Every contiguous run of selected digits in the display order is
+   * sent within one address command in automatic addressing mode. Sent
+   * digits are no longer marked as changed.
+   * @param digitMask Bit mask of screen buffer indexes to send.
+   * @param transform Optional transformation table for digit order.
+   * @return Result code of transfer.
+   */
+  inline ResultCodes busSendDigits(uint8_t digitMask, uint8_t *transform)
+  {
+    if (busSend(Commands::CMD_DATA_INIT | Commands::CMD_DATA_NORMAL |
+                Commands::CMD_DATA_WRITE | Commands::CMD_DATA_AUTO))
+      return getLastResult();
+    uint8_t addrStart = 0;
+    while (addrStart < status_.digits)
+    {
+      if (!isDigitIn(digitMask, addrStart, transform))
       {
-        busWrite(buffer[transform[bufferIndex]]);
+        addrStart++;
+        continue;
       }
-      else
+      uint8_t addrStop = addrStart;
+      while (addrStop < status_.digits &&
+             isDigitIn(digitMask, addrStop, transform))
       {
-        busWrite(*buffer++);
+        addrStop++;
+      }
+      if (busSend(Commands::CMD_ADDR_INIT | addrStart,
+                  addrStart,
+                  addrStop - addrStart,
+                  transform))
+        return getLastResult();
+      for (; addrStart < addrStop; addrStart++)
+      {
+        uint8_t digit = getDigitAt(addrStart, transform);
+        print_.dirty &= ~(1 << digit);
+        blink_.changed &= ~(1 << digit);
       }
-      if (ackTransmission())
-        break;
     }
-    endTransmission();
     return getLastResult();
   }
 
@@ -813,12 +1501,13 @@ private:
   inline uint8_t getFontMask(uint8_t ascii)
   {
     uint8_t mask = FONT_MASK_WRONG;
-    for (uint8_t glyph = 0; glyph < font_.glyphs; glyph++)
+    Bitmap &font = getFont();
+    for (uint8_t glyph = 0; glyph < font.glyphs; glyph++)
     {
       if (ascii ==
-          pgm_read_byte(&font_.table[glyph * FONT_WIDTH + FONT_INDEX_ASCII]))
+          pgm_read_byte(&font.table[glyph * FONT_WIDTH + FONT_INDEX_ASCII]))
       {
-        mask = pgm_read_byte(&font_.table[glyph * 2 + FONT_INDEX_MASK]);
+        mask = pgm_read_byte(&font.table[glyph * 2 + FONT_INDEX_MASK]);
         mask &= 0x7F;
         break;
       }
@@ -0,0 +1,213 @@
+/**
+ * @file gbj_tm1637_anim.h
+ * @brief Streaming player of compressed animations for TM1637 displays.
+ * @details An animation is a byte stream stored in flash memory. The player
+ * decodes one frame per tick directly into the screen buffer of a display
+ * and transmits only changed digits.
+ * @details Stream format:
+ * - The first byte is the number of digits in a frame.
+ * - Every record starts with an operation byte, whose two most significant
+ * bits determine the operation and the rest is its argument.
+ * - KEY (0b01000000): Followed by segment masks of all digits and duration.
+ * - DELTA (0b00mmmmmm): The argument is a bit mask of changed digits with
+ * bit 0 for digit 0. Followed by segment masks of changed digits in
+ * ascending order and duration.
+ * - HOLD (0b10nnnnnn): Keep current frame for (n + 1) times the following
+ * duration.
+ * - END (0b11000000): Stop playing.
+ * - LOOP (0b11000001): Continue from the first record.
+ * - Duration is one byte in units of 10 milliseconds.
+ * - Segment masks contain radix segment in the most significant bit.
+ * @details The script extras/anim7seg.py converts a list of frames to the
+ * stream.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_ANIM_H
+#define GBJ_TM1637_ANIM_H
+
+#include "gbj_tm1637.h"
+
+/**
+ * @class gbj_tm1637_anim
+ * @brief Animation player for one TM1637 display.
+ */
+class gbj_tm1637_anim
+{
+public:
+  /**
+   * @brief Operation codes of animation records.
+   */
+  enum Operations : uint8_t
+  {
+    /** @brief Mask of operation bits in operation byte. */
+    OP_MASK = 0b11000000,
+    /** @brief Frame with changed digits only. */
+    OP_DELTA = 0b00000000,
+    /** @brief Complete frame. */
+    OP_KEY = 0b01000000,
+    /** @brief Repeated duration of current frame. */
+    OP_HOLD = 0b10000000,
+    /** @brief End of animation. */
+    OP_END = 0b11000000,
+    /** @brief Restart of animation. */
+    OP_LOOP = 0b11000001,
+  };
+
+  /**
+   * @brief Construct an animation player for a display.
+   * @param disp Display driver instance for playing.
+   */
+  inline gbj_tm1637_anim(gbj_tm1637 &disp)
+    : disp_(disp)
+  {
+    anim_.running = false;
+  }
+
+  /**
+   * @brief Start playing an animation.
+   * @details The first frame is decoded and transmitted at the next tick.
+   * @param animation Pointer to animation stream in flash memory.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   */
+  inline void start(const uint8_t *animation, uint8_t *digitReorder = 0)
+  {
+    anim_.stream = animation;
+    anim_.digitReorder = digitReorder;
+    anim_.digits = pgm_read_byte(&animation[0]);
+    anim_.position = 1;
+    anim_.wait = 0;
+    anim_.tsFrame = millis();
+    anim_.running = true;
+  }
+
+  /**
+   * @brief Stop playing at current frame.
+   */
+  inline void stop() { anim_.running = false; }
+
+  /**
+   * @brief Play the animation.
+   * @details The method should be called from the main loop. When duration
+   * of current frame elapses, it decodes the next record into the screen
+   * buffer and transmits changed digits.
+   * @return Result code of the transmission, or SUCCESS without one.
+   */
+  inline gbj_tm1637::ResultCodes tick()
+  {
+    if (!anim_.running || millis() - anim_.tsFrame < anim_.wait)
+      return gbj_tm1637::ResultCodes::SUCCESS;
+    anim_.tsFrame += anim_.wait;
+    uint8_t operation = readByte();
+    uint8_t argument = operation & ~Operations::OP_MASK;
+    switch (operation & Operations::OP_MASK)
+    {
+      case Operations::OP_KEY:
+        argument = (1 << anim_.digits) - 1;
+        // Fall through
+      case Operations::OP_DELTA:
+        for (uint8_t digit = 0; digit < anim_.digits; digit++)
+        {
+          if (argument & (1 << digit))
+            printByte(readByte(), digit);
+        }
+        anim_.wait = readByte() * Timing::TIMING_UNIT;
+        return disp_.displayUpdate(anim_.digitReorder);
+
+      case Operations::OP_HOLD:
+        // Long holds exceed 16-bit int on AVR
+        anim_.wait = (uint32_t)(argument + 1) * readByte() *
+                     Timing::TIMING_UNIT;
+        break;
+
+      default:
+        if (operation == Operations::OP_LOOP)
+        {
+          anim_.position = 1;
+          anim_.wait = 0;
+        }
+        else
+        {
+          anim_.running = false;
+        }
+        break;
+    }
+    return gbj_tm1637::ResultCodes::SUCCESS;
+  }
+
+  /**
+   * @brief Check whether an animation is playing.
+   * @return True if the animation has not reached its end.
+   */
+  inline bool isRunning() { return anim_.running; }
+
+private:
+  /**
+   * @brief Timing constants of animation stream.
+   */
+  enum Timing : uint8_t
+  {
+    /** @brief Unit of frame duration in milliseconds. */
+    TIMING_UNIT = 10,
+  };
+
+  /**
+   * @brief Player state.
+   */
+  struct Anim
+  {
+    /** @brief Animation stream in flash memory. */
+    const uint8_t *stream;
+    /** @brief Optional transformation table for digit order. */
+    uint8_t *digitReorder;
+    /** @brief Start time of current frame in milliseconds. */
+    uint32_t tsFrame;
+    /** @brief Duration of current frame in milliseconds. */
+    uint32_t wait;
+    /** @brief Offset of the next record in the stream. */
+    uint16_t position;
+    /** @brief Number of digits in a frame. */
+    uint8_t digits;
+    /** @brief Flag about playing animation. */
+    bool running;
+  } anim_;
+
+  /** @brief Animated display. */
+  gbj_tm1637 &disp_;
+
+  /**
+   * @brief Read next byte of the animation stream.
+   * @return Stream byte.
+   */
+  inline uint8_t readByte()
+  {
+    return pgm_read_byte(&anim_.stream[anim_.position++]);
+  }
+
+  /**
+   * @brief Store segment mask including radix segment to a digit.
+   * @param segmentMask Segment mask with radix segment in MSB.
+   * @param digit Target digit index.
+   */
+  inline void printByte(uint8_t segmentMask, uint8_t digit)
+  {
+    disp_.printDigit(segmentMask, digit);
+    if (segmentMask & 0x80)
+    {
+      disp_.printRadixOn(digit);
+    }
+    else
+    {
+      disp_.printRadixOff(digit);
+    }
+  }
+};
+
+#endif
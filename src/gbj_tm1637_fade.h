@@ -0,0 +1,245 @@
+/**
+ * @file gbj_tm1637_fade.h
+ * @brief Non-blocking brightness fading of TM1637 displays.
+ * @details The fade engine ramps the display contrast from a start level to a
+ * stop level within a duration along an easing curve. It is driven by the
+ * method tick() called from the main loop and transmits only the display
+ * control command at every change of the output level, never the screen
+ * buffer.
+ * @details Optional duty modulation alternates adjacent hardware contrast
+ * levels, or display off and minimal contrast, in order to achieve perceived
+ * sub-levels between 8 hardware steps.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_FADE_H
+#define GBJ_TM1637_FADE_H
+
+#include "gbj_tm1637.h"
+
+/**
+ * @class gbj_tm1637_fade
+ * @brief Brightness ramp engine for one TM1637 display.
+ */
+class gbj_tm1637_fade
+{
+public:
+  /**
+   * @brief Easing curves of the brightness ramp.
+   */
+  enum Easing : uint8_t
+  {
+    /** @brief Constant rate of change. */
+    EASING_LINEAR,
+    /** @brief Slow start with quadratic acceleration. */
+    EASING_IN,
+    /** @brief Quadratic deceleration to slow finish. */
+    EASING_OUT,
+    /** @brief Slow start and slow finish. */
+    EASING_INOUT,
+  };
+
+  /**
+   * @brief Special brightness levels.
+   */
+  enum Levels : uint8_t
+  {
+    /** @brief Display turned off, below minimal contrast. */
+    LEVEL_OFF = 0xFF,
+  };
+
+  /**
+   * @brief Construct a fade engine for a display.
+   * @param disp Display driver instance to be faded.
+   */
+  inline gbj_tm1637_fade(gbj_tm1637 &disp)
+    : disp_(disp)
+  {
+    fade_.running = false;
+  }
+
+  /**
+   * @brief Start a brightness ramp.
+   * @details The ramp runs from the start level, which is applied at the
+   * next tick, to the stop level, which is applied when the duration elapses.
+   * @param levelStart Start contrast level 0 to 7, or LEVEL_OFF.
+   * @param levelStop Stop contrast level 0 to 7, or LEVEL_OFF.
+   * @param duration Ramp duration in milliseconds.
+   * @param easing Easing curve of the ramp.
+   * @param dither Flag about duty modulation for sub-levels.
+   */
+  inline void start(uint8_t levelStart,
+                    uint8_t levelStop,
+                    uint16_t duration,
+                    Easing easing = Easing::EASING_LINEAR,
+                    bool dither = false)
+  {
+    fade_.posStart = levelToPos(levelStart);
+    fade_.posStop = levelToPos(levelStop);
+    fade_.duration = duration;
+    fade_.easing = easing;
+    fade_.dither = dither;
+    fade_.stepSent = Steps::STEP_NONE;
+    fade_.tsStart = millis();
+    fade_.running = true;
+  }
+
+  /**
+   * @brief Stop the running ramp at current brightness.
+   */
+  inline void stop() { fade_.running = false; }
+
+  /**
+   * @brief Process the running ramp.
+   * @details The method should be called from the main loop as often as
+   * possible, with duty modulation at least every 2 milliseconds. It sends
+   * the display control command only if the output level changes.
+   * @return Result code of the recent command, or SUCCESS without one.
+   */
+  inline gbj_tm1637::ResultCodes tick()
+  {
+    if (!fade_.running)
+      return gbj_tm1637::ResultCodes::SUCCESS;
+    uint32_t elapsed = millis() - fade_.tsStart;
+    uint16_t progress = Ramp::RAMP_FULL;
+    if (elapsed < fade_.duration)
+    {
+      progress = elapsed * Ramp::RAMP_FULL / fade_.duration;
+    }
+    else
+    {
+      fade_.running = false;
+    }
+    int16_t pos = fade_.posStart + ((int16_t)(fade_.posStop - fade_.posStart) *
+                                    (int16_t)ease(progress)) /
+                                     Ramp::RAMP_FULL;
+    uint8_t step = pos / Steps::STEP_PARTS;
+    uint8_t part = pos % Steps::STEP_PARTS;
+    if (fade_.dither)
+    {
+      uint8_t slot =
+        (millis() / Timing::TIMING_DITHER) % Steps::STEP_PARTS;
+      if (slot < part)
+        step++;
+    }
+    else if (part >= Steps::STEP_PARTS / 2)
+    {
+      step++;
+    }
+    if (step == fade_.stepSent)
+      return gbj_tm1637::ResultCodes::SUCCESS;
+    fade_.stepSent = step;
+    return step ? disp_.setContrast(step - 1) : disp_.displayOff();
+  }
+
+  /**
+   * @brief Check whether a ramp is running.
+   * @return True if the ramp has not finished yet.
+   */
+  inline bool isRunning() { return fade_.running; }
+
+private:
+  /**
+   * @brief Fixed point scale of the ramp position.
+   */
+  enum Steps : uint8_t
+  {
+    /** @brief Number of sub-levels within one hardware step. */
+    STEP_PARTS = 8,
+    /** @brief Marker of no step sent yet. */
+    STEP_NONE = 0xFF,
+  };
+
+  /**
+   * @brief Fixed point scale of the ramp progress.
+   */
+  enum Ramp : uint16_t
+  {
+    /** @brief Progress value at the end of the ramp. */
+    RAMP_FULL = 256,
+  };
+
+  /**
+   * @brief Timing constants of duty modulation.
+   */
+  enum Timing : uint8_t
+  {
+    /** @brief Duration of one duty slot in milliseconds. */
+    TIMING_DITHER = 2,
+  };
+
+  /**
+   * @brief Ramp state.
+   */
+  struct Fade
+  {
+    /** @brief Start time of the ramp in milliseconds. */
+    uint32_t tsStart;
+    /** @brief Ramp duration in milliseconds. */
+    uint16_t duration;
+    /** @brief Start position in sub-levels. */
+    uint8_t posStart;
+    /** @brief Stop position in sub-levels. */
+    uint8_t posStop;
+    /** @brief Recently sent hardware step, 0 for display off. */
+    uint8_t stepSent;
+    /** @brief Easing curve. */
+    Easing easing;
+    /** @brief Flag about duty modulation. */
+    bool dither;
+    /** @brief Flag about running ramp. */
+    bool running;
+  } fade_;
+
+  /** @brief Faded display. */
+  gbj_tm1637 &disp_;
+
+  /**
+   * @brief Convert contrast level to ramp position.
+   * @details Position 0 is display off, then every hardware contrast level
+   * occupies STEP_PARTS sub-levels.
+   * @param level Contrast level or LEVEL_OFF.
+   * @return Position in sub-levels.
+   */
+  static inline uint8_t levelToPos(uint8_t level)
+  {
+    if (level == Levels::LEVEL_OFF)
+      return 0;
+    level = min(level, gbj_tm1637::getContrastMax());
+    return (level + 1) * Steps::STEP_PARTS;
+  }
+
+  /**
+   * @brief Apply easing curve to linear progress.
+   * @param progress Linear progress 0 to RAMP_FULL.
+   * @return Eased progress 0 to RAMP_FULL.
+   */
+  inline uint16_t ease(uint16_t progress)
+  {
+    uint32_t rest = Ramp::RAMP_FULL - progress;
+    switch (fade_.easing)
+    {
+      case Easing::EASING_IN:
+        return (uint32_t)progress * progress / Ramp::RAMP_FULL;
+
+      case Easing::EASING_OUT:
+        return Ramp::RAMP_FULL - rest * rest / Ramp::RAMP_FULL;
+
+      case Easing::EASING_INOUT:
+        if (progress < Ramp::RAMP_FULL / 2)
+          return (uint32_t)progress * progress / (Ramp::RAMP_FULL / 2);
+        return Ramp::RAMP_FULL - rest * rest / (Ramp::RAMP_FULL / 2);
+
+      default:
+        return progress;
+    }
+  }
+};
+
+#endif
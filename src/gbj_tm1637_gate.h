@@ -0,0 +1,202 @@
+/**
+ * @file gbj_tm1637_gate.h
+ * @brief Value change gate in front of TM1637 display transmission.
+ * @details The gate renders a numeric value into a field of a display and
+ * transmits it only if the rendered segments differ from the displayed ones.
+ * A dead band suppresses flickering of the last digit and a refresh interval
+ * limits the rate of transmissions, so that frequent readings cost just a
+ * comparison.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_GATE_H
+#define GBJ_TM1637_GATE_H
+
+#include "gbj_tm1637.h"
+
+/**
+ * @class gbj_tm1637_gate
+ * @brief Gated numeric output to a field of one TM1637 display.
+ */
+class gbj_tm1637_gate
+{
+public:
+  /**
+   * @brief Construct a gate for a display field.
+   * @param disp Display driver instance for output.
+   * @param field Field of the display where values are rendered.
+   */
+  inline gbj_tm1637_gate(gbj_tm1637 &disp, const gbj_tm1637::Field &field)
+    : disp_(disp)
+    , field_(field)
+  {
+    gate_.deadband = 0;
+    gate_.interval = 0;
+    gate_.shown = false;
+  }
+
+  /**
+   * @brief Set dead band of values.
+   * @details A value closer to the displayed one than the dead band is
+   * neither rendered nor transmitted.
+   * @param deadband Hysteresis in units of the value.
+   */
+  inline void setDeadband(float deadband = 0) { gate_.deadband = deadband; }
+
+  /**
+   * @brief Set minimal time between transmissions.
+   * @details Values coming within the interval after recent transmission are
+   * ignored, so that the gate should be fed continuously.
+   * @param interval Refresh interval in milliseconds, 0 for no limit.
+   */
+  inline void setRefresh(uint16_t interval = 0) { gate_.interval = interval; }
+
+  /**
+   * @brief Render a value into the field and transmit it on change.
+   * @details The value is rendered into the field with the display's font
+   * and only changed digits are transmitted. If the value does not fit the
+   * field, decimal places are dropped one by one. If even the integer part
+   * does not fit, the field is filled with dashes as overflow marker.
+   * @param value Value to be displayed.
+   * @param decimals Number of decimal places up to 6.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   * @return Result code of the transmission, or SUCCESS without one.
+   */
+  inline gbj_tm1637::ResultCodes update(float value,
+                                        uint8_t decimals = 0,
+                                        uint8_t *digitReorder = 0)
+  {
+    if (gate_.shown)
+    {
+      float delta = value - gate_.value;
+      if (delta < gate_.deadband && -delta < gate_.deadband)
+        return gbj_tm1637::ResultCodes::SUCCESS;
+      if (gate_.interval && millis() - gate_.tsSent < gate_.interval)
+        return gbj_tm1637::ResultCodes::SUCCESS;
+    }
+    char text[Limits::LIMIT_TEXT];
+    // Clamped values are wider than any field and end up as overflow
+    const float limit = Limits::LIMIT_VALUE;
+    value = constrain(value, -limit, limit);
+    decimals = min(decimals, (uint8_t)Limits::LIMIT_DECIMALS);
+    while (true)
+    {
+      dtostrf(value, 0, decimals, text);
+      if (isFitting(text) || !decimals)
+        break;
+      decimals--;
+    }
+    uint8_t width = getWidth();
+    if (!isFitting(text))
+    {
+      for (uint8_t i = 0; i < width; i++)
+      {
+        text[i] = '-';
+      }
+      text[width] = '\0';
+    }
+    // Pending changes elsewhere on the display do not count
+    uint8_t segments[GBJ_TM1637_DIGITS];
+    for (uint8_t i = 0; i < width; i++)
+    {
+      segments[i] = disp_.getSegments(field_.digit + i);
+    }
+    disp_.printField(field_, text);
+    if (!isChanged(segments, width))
+      return gbj_tm1637::ResultCodes::SUCCESS;
+    gate_.value = value;
+    gate_.shown = true;
+    gate_.tsSent = millis();
+    return disp_.displayUpdate(digitReorder);
+  }
+
+private:
+  /**
+   * @brief Limits of rendered text.
+   */
+  enum Limits : uint32_t
+  {
+    /** @brief Maximal number of decimal places. */
+    LIMIT_DECIMALS = 6,
+    /** @brief Size of text buffer for sign, 7 digits, point, and decimals. */
+    LIMIT_TEXT = 20,
+    /** @brief Maximal absolute rendered value. */
+    LIMIT_VALUE = 9999999,
+  };
+
+  /**
+   * @brief Gate state.
+   */
+  struct Gate
+  {
+    /** @brief Recently transmitted value. */
+    float value;
+    /** @brief Hysteresis of values. */
+    float deadband;
+    /** @brief Time of recent transmission in milliseconds. */
+    uint32_t tsSent;
+    /** @brief Minimal time between transmissions in milliseconds. */
+    uint16_t interval;
+    /** @brief Flag about some value being transmitted. */
+    bool shown;
+  } gate_;
+
+  /** @brief Display for output. */
+  gbj_tm1637 &disp_;
+
+  /** @brief Field of the display for output. */
+  gbj_tm1637::Field field_;
+
+  /**
+   * @brief Get number of digits of the field within the display.
+   * @return Field width clipped by the display.
+   */
+  inline uint8_t getWidth()
+  {
+    if (field_.digit >= disp_.getDigits())
+      return 0;
+    return min(field_.width, (uint8_t)(disp_.getDigits() - field_.digit));
+  }
+
+  /**
+   * @brief Check whether segments of the field differ from previous ones.
+   * @param segments Segment masks of field digits before rendering.
+   * @param width Number of digits of the field.
+   * @return True if some digit of the field has changed.
+   */
+  inline bool isChanged(const uint8_t *segments, uint8_t width)
+  {
+    for (uint8_t i = 0; i < width; i++)
+    {
+      if (disp_.getSegments(field_.digit + i) != segments[i])
+        return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Check whether a rendered number fits the field.
+   * @details The decimal point shares a digit with the preceding glyph.
+   * @param text Rendered number.
+   * @return True if the number has not more glyphs than the field digits.
+   */
+  inline bool isFitting(const char *text)
+  {
+    uint8_t glyphs = 0;
+    for (size_t i = 0; text[i] != '\0'; i++)
+    {
+      if (text[i] != '.')
+        glyphs++;
+    }
+    return glyphs <= getWidth();
+  }
+};
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * @file gbj_tm1637_meter.h
+ * @brief Bar graph and level meter rendering on TM1637 displays.
+ * @details The meter maps a value range onto segment fills across digits by
+ * precomputed segment tables in flash memory, optionally with a peak hold
+ * marker on radix segments. Only digits with changed segment mask are
+ * transmitted, so that the meter can be refreshed many times per second.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_METER_H
+#define GBJ_TM1637_METER_H
+
+#include "gbj_tm1637.h"
+
+/**
+ * @brief Cumulative segment masks of meter styles for increasing fill.
+ */
+const uint8_t gbjMeter7segTable[] PROGMEM =
+{
+  // Horizontal: left and right vertical segments
+  0b00000000
+, 0b00110000 // E, F
+, 0b00110110 // E, F, B, C
+// Vertical: bottom to top
+, 0b00000000
+, 0b00001000 // D
+, 0b00011100 // D, C, E
+, 0b01011100 // D, C, E, G
+, 0b01111110 // D, C, E, G, B, F
+, 0b01111111 // D, C, E, G, B, F, A
+// Snake: segments clockwise from the top
+, 0b00000000
+, 0b00000001 // A
+, 0b00000011 // A, B
+, 0b00000111 // A, B, C
+, 0b00001111 // A, B, C, D
+, 0b00011111 // A, B, C, D, E
+, 0b00111111 // A, B, C, D, E, F
+};
+
+/**
+ * @class gbj_tm1637_meter
+ * @brief Level meter for one TM1637 display.
+ */
+class gbj_tm1637_meter
+{
+public:
+  /**
+   * @brief Fill styles of the meter.
+   */
+  enum Styles : uint8_t
+  {
+    /** @brief Bar growing from left to right by half digits. */
+    STYLE_HORIZONTAL,
+    /** @brief Bar growing from bottom to top in all digits at once. */
+    STYLE_VERTICAL,
+    /** @brief Segments lit one by one clockwise, digit by digit. */
+    STYLE_SNAKE,
+  };
+
+  /**
+   * @brief Construct a meter for a display.
+   * @param disp Display driver instance for rendering.
+   * @param style Fill style of the meter.
+   */
+  inline gbj_tm1637_meter(gbj_tm1637 &disp,
+                          Styles style = Styles::STYLE_HORIZONTAL)
+    : disp_(disp)
+  {
+    meter_.style = style;
+    meter_.valueMin = 0;
+    meter_.valueMax = 100;
+    meter_.hold = 0;
+    meter_.peak = 0;
+  }
+
+  /**
+   * @brief Set range of rendered values.
+   * @details Values out of range are rendered as empty or full meter.
+   * @param valueMin Value rendered as empty meter.
+   * @param valueMax Value rendered as full meter.
+   */
+  inline void setRange(int16_t valueMin = 0, int16_t valueMax = 100)
+  {
+    meter_.valueMin = valueMin;
+    meter_.valueMax = valueMax;
+  }
+
+  /**
+   * @brief Set duration of the peak hold marker.
+   * @details The radix segment of the digit with the highest recent level is
+   * turned on and other radix segments are turned off. The peak decays to the
+   * current level after the hold time. The vertical style has no marker.
+   * @param hold Hold time in milliseconds, 0 disables the marker.
+   */
+  inline void setPeakHold(uint16_t hold) { meter_.hold = hold; }
+
+  /**
+   * @brief Render a value and transmit changed digits.
+   * @param value Value to be rendered.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   * @return Result code of the transmission.
+   */
+  inline gbj_tm1637::ResultCodes render(int16_t value,
+                                        uint8_t *digitReorder = 0)
+  {
+    uint8_t steps = getSteps();
+    uint8_t level = getLevel(value, steps);
+    uint8_t stepsDigit = getStepsDigit();
+    uint8_t offset = getTableOffset();
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      uint8_t fill = level;
+      if (meter_.style != Styles::STYLE_VERTICAL)
+      {
+        fill = level > digit * stepsDigit ? level - digit * stepsDigit : 0;
+        fill = min(fill, stepsDigit);
+      }
+      disp_.printDigit(pgm_read_byte(&gbjMeter7segTable[offset + fill]),
+                       digit);
+    }
+    if (meter_.hold && meter_.style != Styles::STYLE_VERTICAL)
+    {
+      renderPeak(level, stepsDigit);
+    }
+    return disp_.displayUpdate(digitReorder);
+  }
+
+  /**
+   * @brief Get resolution of the meter.
+   * @return Number of distinguishable nonempty levels.
+   */
+  inline uint8_t getSteps()
+  {
+    if (meter_.style == Styles::STYLE_VERTICAL)
+      return getStepsDigit();
+    return disp_.getDigits() * getStepsDigit();
+  }
+
+private:
+  /**
+   * @brief Start indexes of styles in the segment table.
+   */
+  enum Offsets : uint8_t
+  {
+    OFFSET_HORIZONTAL = 0,
+    OFFSET_VERTICAL = 3,
+    OFFSET_SNAKE = 9,
+  };
+
+  /**
+   * @brief Meter configuration and peak state.
+   */
+  struct Meter
+  {
+    /** @brief Value rendered as empty meter. */
+    int16_t valueMin;
+    /** @brief Value rendered as full meter. */
+    int16_t valueMax;
+    /** @brief Peak hold time in milliseconds. */
+    uint16_t hold;
+    /** @brief Time of recent peak in milliseconds. */
+    uint32_t tsPeak;
+    /** @brief Level of recent peak. */
+    uint8_t peak;
+    /** @brief Fill style. */
+    Styles style;
+  } meter_;
+
+  /** @brief Display for rendering. */
+  gbj_tm1637 &disp_;
+
+  /**
+   * @brief Get number of fill steps within one digit.
+   * @return Number of nonempty segment masks of the style.
+   */
+  inline uint8_t getStepsDigit()
+  {
+    switch (meter_.style)
+    {
+      case Styles::STYLE_VERTICAL:
+        return Offsets::OFFSET_SNAKE - Offsets::OFFSET_VERTICAL - 1;
+
+      case Styles::STYLE_SNAKE:
+        return sizeof(gbjMeter7segTable) - Offsets::OFFSET_SNAKE - 1;
+
+      default:
+        return Offsets::OFFSET_VERTICAL - Offsets::OFFSET_HORIZONTAL - 1;
+    }
+  }
+
+  /**
+   * @brief Get start index of the style in the segment table.
+   * @return Table index of the empty mask of the style.
+   */
+  inline uint8_t getTableOffset()
+  {
+    switch (meter_.style)
+    {
+      case Styles::STYLE_VERTICAL:
+        return Offsets::OFFSET_VERTICAL;
+
+      case Styles::STYLE_SNAKE:
+        return Offsets::OFFSET_SNAKE;
+
+      default:
+        return Offsets::OFFSET_HORIZONTAL;
+    }
+  }
+
+  /**
+   * @brief Map a value to meter level.
+   * @param value Rendered value.
+   * @param steps Resolution of the meter.
+   * @return Level 0 to steps.
+   */
+  inline uint8_t getLevel(int16_t value, uint8_t steps)
+  {
+    if (value <= meter_.valueMin || meter_.valueMax <= meter_.valueMin)
+      return 0;
+    if (value >= meter_.valueMax)
+      return steps;
+    // Spans of the full range exceed 16-bit int on AVR
+    return ((int32_t)value - meter_.valueMin) * steps /
+           ((int32_t)meter_.valueMax - meter_.valueMin);
+  }
+
+  /**
+   * @brief Update peak level and its radix marker.
+   * @param level Current level.
+   * @param stepsDigit Number of fill steps within one digit.
+   */
+  inline void renderPeak(uint8_t level, uint8_t stepsDigit)
+  {
+    if (level >= meter_.peak || millis() - meter_.tsPeak > meter_.hold)
+    {
+      meter_.peak = level;
+      meter_.tsPeak = millis();
+    }
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      if (meter_.peak && digit == (meter_.peak - 1) / stepsDigit)
+      {
+        disp_.printRadixOn(digit);
+      }
+      else
+      {
+        disp_.printRadixOff(digit);
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,341 @@
+/**
+ * @file gbj_tm1637_morph.h
+ * @brief Segment morphing transitions between frames on TM1637 displays.
+ * @details The transition engine morphs the displayed frame into a new one
+ * by intermediate segment frames computed on the fly, one frame per tick,
+ * without storing the sequence. Digits equal in both frames are neither
+ * changed nor transmitted.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_MORPH_H
+#define GBJ_TM1637_MORPH_H
+
+#include "gbj_tm1637.h"
+
+/**
+ * @class gbj_tm1637_morph
+ * @brief Transition engine for one TM1637 display.
+ */
+class gbj_tm1637_morph
+{
+public:
+  /**
+   * @brief Transition effects.
+   */
+  enum Effects : uint8_t
+  {
+    /** @brief Odometer roll, old glyph moves up and new one comes from below. */
+    EFFECT_ROLL,
+    /** @brief Segment columns replaced from left to right. */
+    EFFECT_WIPE_RIGHT,
+    /** @brief Segment columns replaced from right to left. */
+    EFFECT_WIPE_LEFT,
+    /** @brief Segments replaced one by one in scattered order. */
+    EFFECT_DISSOLVE,
+  };
+
+  /**
+   * @brief Construct a transition engine for a display.
+   * @param disp Display driver instance for transitions.
+   */
+  inline gbj_tm1637_morph(gbj_tm1637 &disp)
+    : disp_(disp)
+  {
+    morph_.running = false;
+  }
+
+  /**
+   * @brief Store current screen buffer as the old frame.
+   * @details The method should be called before printing the new content,
+   * which is then morphed to by the method start() without the frame.
+   */
+  inline void capture()
+  {
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      frameOld_[digit] = disp_.getSegments(digit);
+    }
+  }
+
+  /**
+   * @brief Start transition from captured frame to the screen buffer.
+   * @details The screen buffer is restored to the captured frame and morphed
+   * to its current content.
+   * @param effect Transition effect.
+   * @param stepTime Duration of one intermediate frame in milliseconds.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   */
+  inline void start(Effects effect,
+                    uint16_t stepTime = 50,
+                    uint8_t *digitReorder = 0)
+  {
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      frameNew_[digit] = disp_.getSegments(digit);
+      printByte(frameOld_[digit], digit);
+    }
+    begin(effect, stepTime, digitReorder);
+  }
+
+  /**
+   * @brief Start transition from the screen buffer to a new frame.
+   * @param frame Segment masks of all digits including radix segments.
+   * @param effect Transition effect.
+   * @param stepTime Duration of one intermediate frame in milliseconds.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   */
+  inline void start(const uint8_t *frame,
+                    Effects effect,
+                    uint16_t stepTime = 50,
+                    uint8_t *digitReorder = 0)
+  {
+    capture();
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      frameNew_[digit] = frame[digit];
+    }
+    begin(effect, stepTime, digitReorder);
+  }
+
+  /**
+   * @brief Render the next frame of the transition.
+   * @details The method should be called from the main loop. When the step
+   * time elapses, it computes the next frame of changed digits and
+   * transmits them. The last frame is the new frame exactly.
+   * @return Result code of the transmission, or SUCCESS without one.
+   */
+  inline gbj_tm1637::ResultCodes tick()
+  {
+    if (!morph_.running || millis() - morph_.tsStep < morph_.stepTime)
+      return gbj_tm1637::ResultCodes::SUCCESS;
+    morph_.tsStep += morph_.stepTime;
+    morph_.step++;
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      if (morph_.changed & (1 << digit))
+        printByte(getFrameByte(digit), digit);
+    }
+    if (morph_.step >= morph_.steps)
+      morph_.running = false;
+    return disp_.displayUpdate(morph_.digitReorder);
+  }
+
+  /**
+   * @brief Check whether a transition is running.
+   * @return True if the new frame has not been reached yet.
+   */
+  inline bool isRunning() { return morph_.running; }
+
+private:
+  /**
+   * @brief Segment masks.
+   */
+  enum Segments : uint8_t
+  {
+    SEG_A = 0x01,
+    SEG_B = 0x02,
+    SEG_C = 0x04,
+    SEG_D = 0x08,
+    SEG_E = 0x10,
+    SEG_F = 0x20,
+    SEG_G = 0x40,
+    SEG_DP = 0x80,
+    /** @brief Left segment column. */
+    SEG_COL_LEFT = SEG_E | SEG_F,
+    /** @brief Middle segment column. */
+    SEG_COL_MIDDLE = SEG_A | SEG_G | SEG_D,
+    /** @brief Right segment column including radix. */
+    SEG_COL_RIGHT = SEG_B | SEG_C | SEG_DP,
+  };
+
+  /**
+   * @brief Transition lengths in steps.
+   */
+  enum Steps : uint8_t
+  {
+    /** @brief Roll steps per transition. */
+    STEPS_ROLL = 4,
+    /** @brief Wipe steps per digit. */
+    STEPS_WIPE = 3,
+    /** @brief Dissolve steps per transition. */
+    STEPS_DISSOLVE = 8,
+  };
+
+  /**
+   * @brief Transition state.
+   */
+  struct Morph
+  {
+    /** @brief Optional transformation table for digit order. */
+    uint8_t *digitReorder;
+    /** @brief Start time of current step in milliseconds. */
+    uint32_t tsStep;
+    /** @brief Duration of one step in milliseconds. */
+    uint16_t stepTime;
+    /** @brief Bit mask of digits differing in old and new frame. */
+    uint8_t changed;
+    /** @brief Current step. */
+    uint8_t step;
+    /** @brief Number of steps of the transition. */
+    uint8_t steps;
+    /** @brief Transition effect. */
+    Effects effect;
+    /** @brief Flag about running transition. */
+    bool running;
+  } morph_;
+
+  /** @brief Old frame. */
+  uint8_t frameOld_[GBJ_TM1637_DIGITS];
+
+  /** @brief New frame. */
+  uint8_t frameNew_[GBJ_TM1637_DIGITS];
+
+  /** @brief Display for transitions. */
+  gbj_tm1637 &disp_;
+
+  /**
+   * @brief Initialize transition state for stored frames.
+   * @param effect Transition effect.
+   * @param stepTime Duration of one intermediate frame in milliseconds.
+   * @param digitReorder Optional transformation table for digit order.
+   */
+  inline void begin(Effects effect, uint16_t stepTime, uint8_t *digitReorder)
+  {
+    morph_.changed = 0;
+    for (uint8_t digit = 0; digit < disp_.getDigits(); digit++)
+    {
+      if (frameOld_[digit] != frameNew_[digit])
+        morph_.changed |= 1 << digit;
+    }
+    switch (effect)
+    {
+      case Effects::EFFECT_ROLL:
+        morph_.steps = Steps::STEPS_ROLL;
+        break;
+
+      case Effects::EFFECT_DISSOLVE:
+        morph_.steps = Steps::STEPS_DISSOLVE;
+        break;
+
+      default:
+        morph_.steps = Steps::STEPS_WIPE * disp_.getDigits();
+        break;
+    }
+    morph_.effect = effect;
+    morph_.stepTime = stepTime;
+    morph_.digitReorder = digitReorder;
+    morph_.step = 0;
+    morph_.tsStep = millis();
+    morph_.running = morph_.changed;
+  }
+
+  /**
+   * @brief Move glyph segments half a digit up.
+   * @param mask Segment mask.
+   * @return Shifted segment mask without radix.
+   */
+  static inline uint8_t shiftUp(uint8_t mask)
+  {
+    return (mask & SEG_D) << 3 | (mask & SEG_G) >> 6 | (mask & SEG_E) << 1 |
+           (mask & SEG_C) >> 1;
+  }
+
+  /**
+   * @brief Move glyph segments half a digit down.
+   * @param mask Segment mask.
+   * @return Shifted segment mask without radix.
+   */
+  static inline uint8_t shiftDown(uint8_t mask)
+  {
+    return (mask & SEG_A) << 6 | (mask & SEG_G) >> 3 | (mask & SEG_F) >> 1 |
+           (mask & SEG_B) << 1;
+  }
+
+  /**
+   * @brief Compute segment mask of a digit at current step.
+   * @param digit Digit index.
+   * @return Segment mask including radix segment.
+   */
+  inline uint8_t getFrameByte(uint8_t digit)
+  {
+    uint8_t maskOld = frameOld_[digit];
+    uint8_t maskNew = frameNew_[digit];
+    if (morph_.step >= morph_.steps)
+      return maskNew;
+    uint8_t select = 0;
+    switch (morph_.effect)
+    {
+      case Effects::EFFECT_ROLL:
+        // Radix changes with the last step
+        switch (morph_.step)
+        {
+          case 1:
+            return shiftUp(maskOld) | (maskOld & SEG_DP);
+          case 2:
+            return shiftUp(shiftUp(maskOld)) | shiftDown(shiftDown(maskNew)) |
+                   (maskOld & SEG_DP);
+          default:
+            return shiftDown(maskNew) | (maskOld & SEG_DP);
+        }
+
+      case Effects::EFFECT_DISSOLVE:
+        // Scattered order of segments shifted for every digit
+        for (uint8_t i = 0; i < morph_.step; i++)
+        {
+          select |= 1 << ((i * 3 + digit * 5) % Steps::STEPS_DISSOLVE);
+        }
+        break;
+
+      default:
+      {
+        uint8_t column = digit * Steps::STEPS_WIPE;
+        uint8_t columns = morph_.step;
+        if (morph_.effect == Effects::EFFECT_WIPE_LEFT)
+        {
+          // Columns from the right end count reversely
+          column = morph_.steps - column - Steps::STEPS_WIPE;
+          select = (column + 2 < columns ? SEG_COL_LEFT : 0) |
+                   (column + 1 < columns ? SEG_COL_MIDDLE : 0) |
+                   (column < columns ? SEG_COL_RIGHT : 0);
+        }
+        else
+        {
+          select = (column < columns ? SEG_COL_LEFT : 0) |
+                   (column + 1 < columns ? SEG_COL_MIDDLE : 0) |
+                   (column + 2 < columns ? SEG_COL_RIGHT : 0);
+        }
+        break;
+      }
+    }
+    return (maskOld & ~select) | (maskNew & select);
+  }
+
+  /**
+   * @brief Store segment mask including radix segment to a digit.
+   * @param segmentMask Segment mask with radix segment in MSB.
+   * @param digit Target digit index.
+   */
+  inline void printByte(uint8_t segmentMask, uint8_t digit)
+  {
+    disp_.printDigit(segmentMask, digit);
+    if (segmentMask & SEG_DP)
+    {
+      disp_.printRadixOn(digit);
+    }
+    else
+    {
+      disp_.printRadixOff(digit);
+    }
+  }
+};
+
+#endif
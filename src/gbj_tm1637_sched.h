@@ -0,0 +1,299 @@
+/**
+ * @file gbj_tm1637_sched.h
+ * @brief Cooperative scheduler of time based effects on TM1637 displays.
+ * @details The scheduler keeps timed actions of attached displays ordered by
+ * their deadlines. Actions due in the same tick only modify screen buffers
+ * and the scheduler then transmits changed digits once per display, together
+ * with digits changing their blinking phase. It reports the time until the
+ * next deadline, so that the microcontroller can sleep until then.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_SCHED_H
+#define GBJ_TM1637_SCHED_H
+
+#include "gbj_tm1637.h"
+
+/** @brief Capacity of the action queue. */
+#ifndef GBJ_TM1637_SCHED_ACTIONS
+  #define GBJ_TM1637_SCHED_ACTIONS 8
+#endif
+
+/** @brief Maximal number of attached displays. */
+#ifndef GBJ_TM1637_SCHED_DISPLAYS
+  #define GBJ_TM1637_SCHED_DISPLAYS 4
+#endif
+
+/**
+ * @class gbj_tm1637_sched
+ * @brief Deadline ordered scheduler for TM1637 displays.
+ */
+class gbj_tm1637_sched
+{
+public:
+  /**
+   * @brief Action handler.
+   * @details A handler should only manipulate the screen buffer or call other
+   * non-blocking engines, e.g., fade or animation ticks. Changed digits are
+   * transmitted by the scheduler.
+   * @param disp Display the action belongs to.
+   * @param context Arbitrary pointer provided at scheduling.
+   */
+  typedef void (*Handler)(gbj_tm1637 &disp, void *context);
+
+  /**
+   * @brief Construct an empty scheduler.
+   */
+  inline gbj_tm1637_sched()
+  {
+    sched_.actions = 0;
+    sched_.displays = 0;
+  }
+
+  /**
+   * @brief Attach a display to the scheduler.
+   * @param disp Display driver instance.
+   * @param digitReorder Optional transformation table mapping logical buffer
+   * indexes to physical display positions.
+   * @return True if the display is attached.
+   */
+  inline bool attach(gbj_tm1637 &disp, uint8_t *digitReorder = 0)
+  {
+    if (findDisplay(disp) < sched_.displays)
+      return true;
+    if (sched_.displays >= GBJ_TM1637_SCHED_DISPLAYS)
+      return false;
+    displays_[sched_.displays].disp = &disp;
+    displays_[sched_.displays].digitReorder = digitReorder;
+    sched_.displays++;
+    return true;
+  }
+
+  /**
+   * @brief Schedule an action.
+   * @param disp Attached display the action belongs to.
+   * @param handler Action handler.
+   * @param delay Time until the first run in milliseconds.
+   * @param period Repetition period in milliseconds, 0 for single run.
+   * @param context Arbitrary pointer passed to the handler.
+   * @return True if the action is scheduled.
+   */
+  inline bool schedule(gbj_tm1637 &disp,
+                       Handler handler,
+                       uint32_t delay,
+                       uint16_t period = 0,
+                       void *context = 0)
+  {
+    uint8_t display = findDisplay(disp);
+    if (display >= sched_.displays ||
+        sched_.actions >= GBJ_TM1637_SCHED_ACTIONS)
+      return false;
+    Action action;
+    action.deadline = millis() + delay;
+    action.period = period;
+    action.handler = handler;
+    action.context = context;
+    action.display = display;
+    insert(action);
+    return true;
+  }
+
+  /**
+   * @brief Remove all actions with a handler and context.
+   * @param handler Action handler.
+   * @param context Pointer provided at scheduling.
+   */
+  inline void cancel(Handler handler, void *context = 0)
+  {
+    uint8_t index = 0;
+    while (index < sched_.actions)
+    {
+      if (actions_[index].handler == handler &&
+          actions_[index].context == context)
+      {
+        remove(index);
+      }
+      else
+      {
+        index++;
+      }
+    }
+  }
+
+  /**
+   * @brief Run due actions and transmit changes.
+   * @details The method should be called from the main loop, e.g., after
+   * waking up. It runs all actions with elapsed deadline, follows blinking
+   * phases of attached displays, and then transmits changed digits of every
+   * display at once.
+   * @return Result code of the first failed transmission, or SUCCESS.
+   */
+  inline gbj_tm1637::ResultCodes tick()
+  {
+    uint32_t now = millis();
+    while (sched_.actions && isDue(actions_[0].deadline, now))
+    {
+      Action action = actions_[0];
+      remove(0);
+      if (action.period)
+      {
+        action.deadline += action.period;
+        // Skip missed periods instead of running them in a burst
+        if (isDue(action.deadline, now))
+          action.deadline = now + action.period;
+        insert(action);
+      }
+      action.handler(*displays_[action.display].disp, action.context);
+    }
+    gbj_tm1637::ResultCodes result = gbj_tm1637::ResultCodes::SUCCESS;
+    for (uint8_t display = 0; display < sched_.displays; display++)
+    {
+      gbj_tm1637 &disp = *displays_[display].disp;
+      disp.printBlink();
+      if (disp.displayUpdate(displays_[display].digitReorder) && !result)
+        result = disp.getLastResult();
+    }
+    return result;
+  }
+
+  /**
+   * @brief Get time until the next action or blinking phase change.
+   * @return Time in milliseconds, 0 for due action, or 0xFFFFFFFF without
+   * scheduled actions and blinking.
+   */
+  inline uint32_t getWait()
+  {
+    uint32_t wait = Timing::TIMING_IDLE;
+    uint32_t now = millis();
+    if (sched_.actions)
+    {
+      wait = isDue(actions_[0].deadline, now) ? 0 : actions_[0].deadline - now;
+    }
+    for (uint8_t display = 0; display < sched_.displays; display++)
+    {
+      uint16_t blinkWait = displays_[display].disp->getBlinkWait();
+      if (blinkWait != 0xFFFF)
+        wait = min(wait, (uint32_t)blinkWait);
+    }
+    return wait;
+  }
+
+  /**
+   * @brief Get number of scheduled actions.
+   * @return Number of actions in the queue.
+   */
+  inline uint8_t getActions() { return sched_.actions; }
+
+private:
+  /**
+   * @brief Timing constants.
+   */
+  enum Timing : uint32_t
+  {
+    /** @brief Waiting time without any scheduled event. */
+    TIMING_IDLE = 0xFFFFFFFF,
+  };
+
+  /**
+   * @brief Scheduled action.
+   */
+  struct Action
+  {
+    /** @brief Time of the next run in milliseconds. */
+    uint32_t deadline;
+    /** @brief Action handler. */
+    Handler handler;
+    /** @brief Pointer passed to the handler. */
+    void *context;
+    /** @brief Repetition period in milliseconds. */
+    uint16_t period;
+    /** @brief Index of attached display. */
+    uint8_t display;
+  } actions_[GBJ_TM1637_SCHED_ACTIONS];
+
+  /**
+   * @brief Attached display.
+   */
+  struct Display
+  {
+    /** @brief Display driver instance. */
+    gbj_tm1637 *disp;
+    /** @brief Optional transformation table for digit order. */
+    uint8_t *digitReorder;
+  } displays_[GBJ_TM1637_SCHED_DISPLAYS];
+
+  /**
+   * @brief Queue state.
+   */
+  struct Sched
+  {
+    /** @brief Number of scheduled actions. */
+    uint8_t actions;
+    /** @brief Number of attached displays. */
+    uint8_t displays;
+  } sched_;
+
+  /**
+   * @brief Check whether a deadline has elapsed, robust to timer overflow.
+   * @param deadline Deadline in milliseconds.
+   * @param now Current time in milliseconds.
+   * @return True if the deadline is not in the future.
+   */
+  static inline bool isDue(uint32_t deadline, uint32_t now)
+  {
+    return (int32_t)(now - deadline) >= 0;
+  }
+
+  /**
+   * @brief Find index of an attached display.
+   * @param disp Display driver instance.
+   * @return Index of the display, or number of displays if not attached.
+   */
+  inline uint8_t findDisplay(gbj_tm1637 &disp)
+  {
+    uint8_t display = 0;
+    while (display < sched_.displays && displays_[display].disp != &disp)
+    {
+      display++;
+    }
+    return display;
+  }
+
+  /**
+   * @brief Insert an action keeping the queue ordered by deadlines.
+   * @details Actions with equal deadlines keep order of insertion.
+   * @param action Action to insert.
+   */
+  inline void insert(const Action &action)
+  {
+    uint8_t index = sched_.actions++;
+    while (index > 0 &&
+           (int32_t)(action.deadline - actions_[index - 1].deadline) < 0)
+    {
+      actions_[index] = actions_[index - 1];
+      index--;
+    }
+    actions_[index] = action;
+  }
+
+  /**
+   * @brief Remove an action from the queue.
+   * @param index Index of the action.
+   */
+  inline void remove(uint8_t index)
+  {
+    sched_.actions--;
+    for (; index < sched_.actions; index++)
+    {
+      actions_[index] = actions_[index + 1];
+    }
+  }
+};
+
+#endif
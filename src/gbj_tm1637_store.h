@@ -0,0 +1,269 @@
+/**
+ * @file gbj_tm1637_store.h
+ * @brief Persistent storage of TM1637 display snapshots in EEPROM.
+ * @details The store keeps the recent display snapshot in a ring of slots in
+ * EEPROM, so that the display can be restored right after restart. Every
+ * slot carries a sequence number and a checksum. A snapshot equal to the
+ * stored one is not written at all, and changed snapshots are written to the
+ * next slot in the ring, which spreads wear over all slots on AVR. On ESP8266
+ * and ESP32 the EEPROM is emulated in flash memory and the sketch has to call
+ * EEPROM.begin() with a size covering the store before using it. Every commit
+ * there rewrites the whole emulated sector whichever slot changed, so that
+ * skipping unchanged snapshots is the only wear reduction.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the license GNU GPL v3
+ * http://www.gnu.org/licenses/gpl-3.0.html (related to original code) and MIT
+ * License (MIT) for added code.
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_tm1637.git
+ */
+#ifndef GBJ_TM1637_STORE_H
+#define GBJ_TM1637_STORE_H
+
+#include "gbj_tm1637.h"
+#include <EEPROM.h>
+
+/**
+ * @class gbj_tm1637_store
+ * @brief Wear aware EEPROM ring of display snapshots.
+ */
+class gbj_tm1637_store
+{
+public:
+  /**
+   * @brief Construct a store in an EEPROM area.
+   * @param address EEPROM address of the first slot.
+   * @param slots Number of slots in the ring.
+   */
+  inline gbj_tm1637_store(uint16_t address = 0, uint8_t slots = 4)
+  {
+    store_.address = address;
+    store_.slots = max(slots, (uint8_t)1);
+    store_.scanned = false;
+  }
+
+  /**
+   * @brief Read the recent snapshot.
+   * @param snapshot Snapshot to be filled.
+   * @return True if a valid snapshot has been found.
+   */
+  inline bool load(gbj_tm1637::Snapshot &snapshot)
+  {
+    if (!scan())
+      return false;
+    uint16_t address = getSlotAddress(store_.slot) + 1;
+    for (uint8_t digit = 0; digit < GBJ_TM1637_DIGITS; digit++)
+    {
+      snapshot.frame[digit] = EEPROM.read(address++);
+    }
+    uint8_t control = EEPROM.read(address);
+    snapshot.contrast = control & Layout::LAYOUT_CONTRAST;
+    snapshot.state = control & Layout::LAYOUT_STATE;
+    return true;
+  }
+
+  /**
+   * @brief Write a snapshot if it differs from the stored one.
+   * @param snapshot Snapshot to be stored, e.g., from getSnapshot().
+   * @return True if the snapshot has been written.
+   */
+  inline bool save(const gbj_tm1637::Snapshot &snapshot)
+  {
+    uint8_t data[Layout::LAYOUT_DATA];
+    for (uint8_t digit = 0; digit < GBJ_TM1637_DIGITS; digit++)
+    {
+      data[digit] = snapshot.frame[digit];
+    }
+    data[GBJ_TM1637_DIGITS] = (snapshot.contrast & Layout::LAYOUT_CONTRAST) |
+                              (snapshot.state ? Layout::LAYOUT_STATE : 0);
+    uint8_t sequence = 0;
+    uint8_t slot = 0;
+    if (scan())
+    {
+      if (isEqual(store_.slot, data))
+        return false;
+      sequence = store_.sequence + 1;
+      slot = (store_.slot + 1) % store_.slots;
+    }
+    uint16_t address = getSlotAddress(slot);
+    // The recent slot is not overwritten, so that an interrupted write
+    // leaves it valid
+    writeByte(address, sequence);
+    for (uint8_t index = 0; index < Layout::LAYOUT_DATA; index++)
+    {
+      writeByte(address + 1 + index, data[index]);
+    }
+    writeByte(address + 1 + Layout::LAYOUT_DATA, getChecksum(sequence, data));
+#if defined(ESP8266) || defined(ESP32)
+    EEPROM.commit();
+#endif
+    store_.slot = slot;
+    store_.sequence = sequence;
+    store_.scanned = true;
+    return true;
+  }
+
+  /**
+   * @brief Get EEPROM size occupied by the store.
+   * @return Number of bytes from the store address.
+   */
+  inline uint16_t getSize() { return store_.slots * Layout::LAYOUT_SLOT; }
+
+private:
+  /**
+   * @brief Slot layout: sequence, frame, control byte, and checksum.
+   */
+  enum Layout : uint8_t
+  {
+    /** @brief Bits of contrast in the control byte. */
+    LAYOUT_CONTRAST = 0x07,
+    /** @brief Bit of display state in the control byte. */
+    LAYOUT_STATE = 0x08,
+    /** @brief Number of data bytes of a slot. */
+    LAYOUT_DATA = GBJ_TM1637_DIGITS + 1,
+    /** @brief Number of bytes of a slot. */
+    LAYOUT_SLOT = GBJ_TM1637_DIGITS + 3,
+  };
+
+  /**
+   * @brief Ring state.
+   */
+  struct Store
+  {
+    /** @brief EEPROM address of the first slot. */
+    uint16_t address;
+    /** @brief Number of slots in the ring. */
+    uint8_t slots;
+    /** @brief Slot with the recent snapshot. */
+    uint8_t slot;
+    /** @brief Sequence number of the recent snapshot. */
+    uint8_t sequence;
+    /** @brief Flag about found recent snapshot. */
+    bool scanned;
+  } store_;
+
+  /**
+   * @brief Get EEPROM address of a slot.
+   * @param slot Slot index.
+   * @return Address of the sequence byte of the slot.
+   */
+  inline uint16_t getSlotAddress(uint8_t slot)
+  {
+    return store_.address + slot * Layout::LAYOUT_SLOT;
+  }
+
+  /**
+   * @brief Write a byte to EEPROM only if it differs from the stored one.
+   * @param address EEPROM address.
+   * @param value Byte to write.
+   */
+  inline void writeByte(uint16_t address, uint8_t value)
+  {
+#if defined(ESP8266) || defined(ESP32)
+    // Emulated EEPROM marks itself changed only if the byte differs, but the
+    // commit rewrites the whole sector
+    EEPROM.write(address, value);
+#else
+    EEPROM.update(address, value);
+#endif
+  }
+
+  /**
+   * @brief Calculate checksum of a slot by CRC-8 (Dallas/Maxim).
+   * @details The checksum is inverted, so that erased memory is not valid.
+   * @param sequence Sequence number of the slot.
+   * @param data Data bytes of the slot.
+   * @return Checksum byte.
+   */
+  static inline uint8_t getChecksum(uint8_t sequence, const uint8_t *data)
+  {
+    uint8_t crc = 0;
+    for (uint8_t index = 0; index <= Layout::LAYOUT_DATA; index++)
+    {
+      uint8_t value = index ? data[index - 1] : sequence;
+      for (uint8_t bit = 0; bit < 8; bit++)
+      {
+        uint8_t mix = (crc ^ value) & 0x01;
+        crc >>= 1;
+        if (mix)
+          crc ^= 0x8C;
+        value >>= 1;
+      }
+    }
+    return ~crc;
+  }
+
+  /**
+   * @brief Read data bytes of a slot.
+   * @param slot Slot index.
+   * @param data Buffer for data bytes.
+   * @return Sequence number of the slot.
+   */
+  inline uint8_t readSlot(uint8_t slot, uint8_t *data)
+  {
+    uint16_t address = getSlotAddress(slot);
+    for (uint8_t index = 0; index < Layout::LAYOUT_DATA; index++)
+    {
+      data[index] = EEPROM.read(address + 1 + index);
+    }
+    return EEPROM.read(address);
+  }
+
+  /**
+   * @brief Check whether a slot has valid checksum.
+   * @param slot Slot index.
+   * @param sequence Sequence number of the slot.
+   * @return True if the slot is valid.
+   */
+  inline bool isValid(uint8_t slot, uint8_t &sequence)
+  {
+    uint8_t data[Layout::LAYOUT_DATA];
+    sequence = readSlot(slot, data);
+    return EEPROM.read(getSlotAddress(slot) + 1 + Layout::LAYOUT_DATA) ==
+           getChecksum(sequence, data);
+  }
+
+  /**
+   * @brief Check whether a slot stores the data bytes.
+   * @param slot Slot index.
+   * @param data Data bytes to compare.
+   * @return True if all data bytes are equal.
+   */
+  inline bool isEqual(uint8_t slot, const uint8_t *data)
+  {
+    uint8_t stored[Layout::LAYOUT_DATA];
+    readSlot(slot, stored);
+    return memcmp(stored, data, Layout::LAYOUT_DATA) == 0;
+  }
+
+  /**
+   * @brief Find the slot with the recent snapshot.
+   * @details Slots are written in the ring order with increasing sequence
+   * numbers, so that the recent one is the valid slot with the newest
+   * sequence number. The result is cached.
+   * @return True if a valid slot exists.
+   */
+  inline bool scan()
+  {
+    if (store_.scanned)
+      return true;
+    for (uint8_t slot = 0; slot < store_.slots; slot++)
+    {
+      uint8_t sequence;
+      if (!isValid(slot, sequence))
+        continue;
+      // Sequence numbers wrap around, so that only their distance matters
+      if (!store_.scanned || (int8_t)(sequence - store_.sequence) > 0)
+      {
+        store_.slot = slot;
+        store_.sequence = sequence;
+        store_.scanned = true;
+      }
+    }
+    return store_.scanned;
+  }
+};
+
+#endif